@@ -0,0 +1,74 @@
+#include "../src/ecs/sparse_set.hpp"
+#include "../src/ecs/types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+const int LOOKUP_PASSES = 4;
+const int RUNS = 5;
+
+// The index `ComponentArray` kept before the sparse set.
+class MapIndex {
+	private:
+		std::unordered_map<EntityId, size_t> entityToIndexMap {};
+		std::unordered_map<size_t, EntityId> indexToEntityMap {};
+
+	public:
+		void insert(Entity entity) {
+			auto index = entityToIndexMap.size();
+			entityToIndexMap[entity.id] = index;
+			indexToEntityMap[index] = entity.id;
+		};
+
+		size_t indexOf(Entity entity) const { return entityToIndexMap.find(entity.id)->second; };
+
+		void remove(Entity entity) {
+			auto removed = entityToIndexMap[entity.id];
+			auto lastIndex = entityToIndexMap.size() - 1;
+			auto last = indexToEntityMap[lastIndex];
+			entityToIndexMap[last] = removed;
+			indexToEntityMap[removed] = last;
+			entityToIndexMap.erase(entity.id);
+			indexToEntityMap.erase(lastIndex);
+		};
+};
+
+template <typename Index>
+double run(const std::vector<Entity> &entities, size_t &checksum) {
+	double best = 0.0;
+	for (int i = 0; i < RUNS; i++) {
+		auto start = std::chrono::steady_clock::now();
+		{
+			Index index;
+			for (auto entity : entities) index.insert(entity);
+			for (int pass = 0; pass < LOOKUP_PASSES; pass++) {
+				for (auto entity : entities) checksum += index.indexOf(entity);
+			}
+			for (size_t j = 0; j < entities.size() / 2; j++) index.remove(entities[j]);
+		}
+		double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (i == 0 || elapsed < best) best = elapsed;
+	}
+	return best;
+}
+
+// Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+int main() {
+	size_t checksum = 0;
+	std::printf("%10s %12s %12s\n", "entities", "sparse (ms)", "maps (ms)");
+	for (size_t count : { 1000, 65536, 1000000 }) {
+		std::vector<Entity> entities(count);
+		for (size_t i = 0; i < count; i++) entities[i] = { .id = static_cast<EntityId>(i), .generation = 0 };
+		std::shuffle(entities.begin(), entities.end(), std::mt19937(1));
+
+		auto sparse = run<SparseSet>(entities, checksum);
+		auto maps = run<MapIndex>(entities, checksum);
+		std::printf("%10zu %12.3f %12.3f\n", count, sparse, maps);
+	}
+	volatile size_t sink = checksum;
+	(void) sink;
+}
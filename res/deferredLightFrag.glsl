@@ -0,0 +1,32 @@
+#version 330 core
+
+#include "lighting.glsl"
+
+out vec4 fragColor;
+
+uniform sampler2D gAlbedo;
+uniform sampler2D gSpecular;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+layout (std140) uniform Camera {
+	mat4 view;
+	mat4 projection;
+	mat4 inverseProjection;
+};
+
+void main() {
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(gDepth, pixel, 0).r;
+	if (depth == 1.0) discard;
+
+	vec4 clipPos = vec4(gl_FragCoord.xy / vec2(textureSize(gDepth, 0)) * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+	vec4 viewPos = inverseProjection * clipPos;
+	vec3 fragPos = viewPos.xyz / viewPos.w;
+
+	vec4 specularShininess = texelFetch(gSpecular, pixel, 0);
+	Surface surface = Surface(texelFetch(gAlbedo, pixel, 0).rgb, specularShininess.rgb, specularShininess.a * 256.0);
+	vec3 normal = normalize(texelFetch(gNormal, pixel, 0).xyz);
+
+	fragColor = vec4(calculateLighting(surface, normal, fragPos, gl_FragCoord.xy), 1.0);
+}
@@ -0,0 +1,22 @@
+#version 330 core
+
+struct Material {
+	sampler2D texDiffuse0;
+	sampler2D texSpecular0;
+	float shininess;
+};
+
+in vec3 fFragPos;
+in vec3 fNormal;
+in vec2 fTexCoords;
+layout (location = 0) out vec4 gAlbedo;
+layout (location = 1) out vec4 gSpecular;
+layout (location = 2) out vec4 gNormal;
+
+uniform Material material;
+
+void main() {
+	gAlbedo = vec4(texture(material.texDiffuse0, fTexCoords).rgb, 1.0);
+	gSpecular = vec4(texture(material.texSpecular0, fTexCoords).rgb, material.shininess / 256.0);
+	gNormal = vec4(normalize(fNormal), 0.0);
+}
\ No newline at end of file
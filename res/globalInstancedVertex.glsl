@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in mat3 aNormalMatrix;
+
+out vec3 fFragPos;
+out vec3 fNormal;
+out vec2 fTexCoords;
+
+layout (std140) uniform Camera {
+	mat4 view;
+	mat4 projection;
+};
+
+void main() {
+	vec3 fragPos = (view * aModel * vec4(aPos, 1.0)).xyz;
+	fFragPos = fragPos;
+	fNormal = mat3(view) * aNormalMatrix * aNormal;
+	fTexCoords = aTexCoords;
+
+	gl_Position = projection * vec4(fragPos, 1.0);
+}
\ No newline at end of file
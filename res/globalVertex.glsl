@@ -8,10 +8,13 @@ out vec3 fNormal;
 out vec2 fTexCoords;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform mat3 normalMatrix;
 
+layout (std140) uniform Camera {
+	mat4 view;
+	mat4 projection;
+};
+
 void main() {
 	vec3 fragPos = (view * model * vec4(aPos, 1.0)).xyz;
 	fFragPos = fragPos;
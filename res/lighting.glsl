@@ -0,0 +1,106 @@
+// Included after `#version` by the forward and deferred shaders.
+
+const int MAX_DIRECTIONAL_LIGHTS = 32;
+const int LOCAL_LIGHT_TEXELS = 5;
+
+struct Surface {
+	vec3 albedo;
+	vec3 specular;
+	float shininess;
+};
+
+struct LightProperties {
+	vec3 ambient;
+	vec3 diffuse;
+	vec3 specular;
+};
+
+struct DirectionalLight {
+	vec3 direction;
+	LightProperties properties;
+};
+
+layout (std140) uniform Lights {
+	DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
+	int nDirectionalLights;
+};
+
+layout (std140) uniform Clusters {
+	ivec3 clusterCounts;
+	vec2 clusterTileSize;
+	float clusterDepthScale;
+	float clusterDepthBias;
+};
+
+uniform samplerBuffer clusterLights;
+uniform usamplerBuffer clusterGrid;
+uniform usamplerBuffer clusterIndices;
+
+vec3 calculateDirectionalLight(DirectionalLight light, Surface surface, vec3 normal, vec3 viewDir) {
+	vec3 lightDir = normalize(-light.direction);
+	vec3 diffuseMapValue = surface.albedo;
+
+	float diffuseValue = max(dot(normal, lightDir), 0.0);
+
+	vec3 reflectDir = reflect(-lightDir, normal);
+	float specularValue = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+
+	vec3 ambient = light.properties.ambient * diffuseMapValue;
+	vec3 diffuse = light.properties.diffuse * diffuseValue * diffuseMapValue;
+	vec3 specular = light.properties.specular * specularValue * surface.specular;
+
+	return ambient + diffuse + specular;
+}
+
+// A point light is a spot light whose cone covers every direction.
+vec3 calculateLocalLight(int index, Surface surface, vec3 normal, vec3 fragPos, vec3 viewDir) {
+	vec4 positionRange = texelFetch(clusterLights, index * LOCAL_LIGHT_TEXELS);
+	vec4 directionPhi = texelFetch(clusterLights, index * LOCAL_LIGHT_TEXELS + 1);
+	vec4 ambientGamma = texelFetch(clusterLights, index * LOCAL_LIGHT_TEXELS + 2);
+	vec4 diffuseLinear = texelFetch(clusterLights, index * LOCAL_LIGHT_TEXELS + 3);
+	vec4 specularQuadratic = texelFetch(clusterLights, index * LOCAL_LIGHT_TEXELS + 4);
+
+	vec3 lightDir = normalize(positionRange.xyz - fragPos);
+	vec3 diffuseMapValue = surface.albedo;
+
+	float diffuseValue = max(dot(normal, lightDir), 0.0);
+
+	vec3 reflectDir = reflect(-lightDir, normal);
+	float specularValue = pow(max(dot(viewDir, reflectDir), 0.0), surface.shininess);
+
+	float dist = distance(positionRange.xyz, fragPos);
+	float attenuation = 1.0 / (1.0 + diffuseLinear.w * dist + specularQuadratic.w * dist * dist);
+	// Fades out so lights don't pop at the edges of their clusters.
+	float window = clamp(1.0 - pow(dist / positionRange.w, 4.0), 0.0, 1.0);
+
+	float theta = dot(lightDir, normalize(-directionPhi.xyz));
+	float epsilon = directionPhi.w - ambientGamma.w;
+	float intensity = clamp((theta - ambientGamma.w) / epsilon, 0.0, 1.0);
+
+	vec3 ambient = ambientGamma.rgb * diffuseMapValue;
+	vec3 diffuse = diffuseLinear.rgb * diffuseMapValue * diffuseValue;
+	vec3 specular = specularQuadratic.rgb * surface.specular * specularValue;
+
+	return (ambient + diffuse + specular) * attenuation * window * window * intensity;
+}
+
+// `fragPos` and `normal` are in view space.
+vec3 calculateLighting(Surface surface, vec3 normal, vec3 fragPos, vec2 fragCoord) {
+	vec3 viewDir = normalize(-fragPos);
+
+	vec3 result = vec3(0.0);
+
+	for (int i = 0; i < nDirectionalLights; i++)
+		result += calculateDirectionalLight(directionalLights[i], surface, normal, viewDir);
+
+	ivec3 cluster = ivec3(
+		ivec2(fragCoord / clusterTileSize),
+		int(log(-fragPos.z) * clusterDepthScale + clusterDepthBias)
+	);
+	cluster = clamp(cluster, ivec3(0), clusterCounts - 1);
+	uvec2 lights = texelFetch(clusterGrid, cluster.x + clusterCounts.x * (cluster.y + clusterCounts.y * cluster.z)).xy;
+	for (uint i = 0u; i < lights.y; i++)
+		result += calculateLocalLight(int(texelFetch(clusterIndices, int(lights.x + i)).x), surface, normal, fragPos, viewDir);
+
+	return result;
+}
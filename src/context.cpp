@@ -2,19 +2,42 @@
 
 #include "ecs/components/camera.hpp"
 #include "ecs/components/light.hpp"
+#include "ecs/components/occluder.hpp"
+#include "ecs/components/parent.hpp"
+#include "ecs/components/static.hpp"
 #include "ecs/components/transform.hpp"
 #include "ecs/entity.hpp"
+#include "ecs/hierarchy.hpp"
+#include "ecs/prefab.hpp"
 #include "ecs/scene.hpp"
+#include "ecs/scene_bvh.hpp"
+#include "ecs/snapshot.hpp"
+#include "ecs/system.hpp"
+#include "graphics/buffer_texture.hpp"
+#include "graphics/culler.hpp"
+#include "graphics/g_buffer.hpp"
 #include "graphics/model.hpp"
+#include "graphics/render_queue.hpp"
 #include "graphics/shader.hpp"
+#include "graphics/uniform_buffer.hpp"
+#include "graphics/uniforms.hpp"
 #include "input/input.hpp"
+#include "util/frustum.hpp"
+#include "util/light_clusters.hpp"
+#include "util/occlusion.hpp"
+#include "util/thread_pool.hpp"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
 #include <optional>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <tuple>
@@ -22,6 +45,46 @@
 #include <utility>
 #include <vector>
 
+const std::string WINDOW_TITLE = "Learn OpenGL";
+const float STATS_INTERVAL = 0.5f;
+
+struct FrameCamera {
+	glm::mat4 view;
+	glm::mat4 projection;
+};
+
+struct FrameLights {
+	LightUniforms uniforms;
+	std::vector<LocalLightTexels> localLights;
+	std::vector<glm::vec4> spheres;
+};
+
+template <>
+struct Resource<FrameCamera> : std::true_type {};
+template <>
+struct Resource<FrameLights> : std::true_type {};
+template <>
+struct Resource<TransformHierarchy> : std::true_type {};
+template <>
+struct Resource<SceneBVH> : std::true_type {};
+template <>
+struct Resource<OcclusionBuffer> : std::true_type {};
+template <>
+struct Resource<LightClusters> : std::true_type {};
+template <>
+struct Resource<RenderQueue> : std::true_type {};
+
+std::string statsTitle(float framesPerSecond, const CullStats &cull, const RenderStats &render, const GLStateStats &state) {
+	std::ostringstream title;
+	title << WINDOW_TITLE << " | " << static_cast<int>(framesPerSecond + 0.5f) << " fps | models: "
+		<< cull.visibleModels << "/" << cull.models << " visible, " << cull.occludedModels << " occluded | meshes: "
+		<< cull.visibleMeshes << "/" << cull.meshes << " visible, " << cull.occludedMeshes << " occluded | "
+		<< render.draws << " draws, " << render.instances << " instances | switches: "
+		<< render.programSwitches << " program, " << render.textureSwitches << " texture, " << render.vaoSwitches << " VAO | GL state: "
+		<< state.issued << " issued, " << state.elided << " elided";
+	return title.str();
+}
+
 GLFWwindow *initializeGLFW() {
 	glfwInit();
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -31,7 +94,7 @@ GLFWwindow *initializeGLFW() {
 		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 	#endif
 
-	GLFWwindow *window = glfwCreateWindow(INITIAL_WINDOW_WIDTH, INITIAL_WINDOW_HEIGHT, "Learn OpenGL", nullptr, nullptr);
+	GLFWwindow *window = glfwCreateWindow(INITIAL_WINDOW_WIDTH, INITIAL_WINDOW_HEIGHT, WINDOW_TITLE.c_str(), nullptr, nullptr);
 	if (window == nullptr) {
 		glfwTerminate();
 		return nullptr;
@@ -41,9 +104,11 @@ GLFWwindow *initializeGLFW() {
 	return window;
 }
 
-Context::Context() :
+Context::Context(RenderPath renderPath, const std::string &snapshotPath) :
 	screen { .width = INITIAL_WINDOW_WIDTH, .height = INITIAL_WINDOW_HEIGHT },
 	time { .now = 0.0f, .delta = 0.0f, .last = 0.0f },
+	renderPath(renderPath),
+	snapshotPath(snapshotPath),
 	window(initializeGLFW()),
 	input(std::make_unique<InputManager>(*this))
 {
@@ -55,8 +120,8 @@ Context::Context() :
 		throw std::runtime_error("Failed to initialize GLAD.");
 	}
 
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
+	glState.setDepthTest(true);
+	glState.setCullFace(true);
 }
 
 Context::~Context() {
@@ -78,7 +143,13 @@ void Context::processFramebufferSize() {
 std::shared_ptr<ShaderProgram> Context::compileShader(const std::string &vertexSourcePath, const std::string &fragmentSourcePath) {
 	auto shaderOpt = shaders.get(vertexSourcePath + ":" + fragmentSourcePath);
 	if (!shaderOpt) {
-		auto shader = std::make_shared<ShaderProgram>(vertexSourcePath, fragmentSourcePath);
+		auto shader = std::make_shared<ShaderProgram>(glState, vertexSourcePath, fragmentSourcePath);
+		shader->bindUniformBlock("Camera", UNIFORM_BINDING_CAMERA);
+		shader->bindUniformBlock("Lights", UNIFORM_BINDING_LIGHTS);
+		shader->bindUniformBlock("Clusters", UNIFORM_BINDING_CLUSTERS);
+		shader->tryUniformInt("clusterLights", TEXTURE_UNIT_CLUSTER_LIGHTS);
+		shader->tryUniformInt("clusterGrid", TEXTURE_UNIT_CLUSTER_GRID);
+		shader->tryUniformInt("clusterIndices", TEXTURE_UNIT_CLUSTER_INDICES);
 		shaders.set(vertexSourcePath + ":" + fragmentSourcePath, shader);
 		shaderOpt = shaders.get(vertexSourcePath + ":" + fragmentSourcePath);
 	}
@@ -95,49 +166,17 @@ std::shared_ptr<Model> Context::loadModel(const std::string &path) {
 	return modelOpt.value();
 }
 
-void Context::loop() {
-	Scene scene;
-
+void Context::populateScene(Scene &scene) {
 	auto mainCamera = scene.createEntity();
-	auto mainCameraTransform = std::make_shared<Transform>();
-	auto mainCameraComponent = std::make_shared<Camera>(mainCameraTransform);
-	mainCameraComponent->setMain(true);
-	mainCamera->addComponent(mainCameraTransform);
-	mainCamera->addComponent(mainCameraComponent);
-
-	input->addKeyCallback(GLFW_KEY_ESCAPE, PRESS, [](auto &ctx) { glfwSetWindowShouldClose(ctx.window, true); });
-	input->addKeyCallback(GLFW_KEY_W, PRESS, [mainCameraComponent, mainCameraTransform](auto &ctx) mutable { mainCameraComponent->move(mainCameraTransform, FORWARD, ctx.time.delta); });
-	input->addKeyCallback(GLFW_KEY_S, PRESS, [mainCameraComponent, mainCameraTransform](auto &ctx) mutable { mainCameraComponent->move(mainCameraTransform, BACKWARD, ctx.time.delta); });
-	input->addKeyCallback(GLFW_KEY_A, PRESS, [mainCameraComponent, mainCameraTransform](auto &ctx) mutable { mainCameraComponent->move(mainCameraTransform, LEFT, ctx.time.delta); });
-	input->addKeyCallback(GLFW_KEY_D, PRESS, [mainCameraComponent, mainCameraTransform](auto &ctx) mutable { mainCameraComponent->move(mainCameraTransform, RIGHT, ctx.time.delta); });
-	input->addKeyCallback(GLFW_KEY_SPACE, PRESS, [mainCameraComponent, mainCameraTransform](auto &ctx) mutable { mainCameraComponent->move(mainCameraTransform, UP, ctx.time.delta); });
-	input->addKeyCallback(GLFW_KEY_LEFT_SHIFT, PRESS, [mainCameraComponent, mainCameraTransform](auto &ctx) mutable { mainCameraComponent->move(mainCameraTransform, DOWN, ctx.time.delta); });
-	input->addKeyCallback(GLFW_KEY_Q, RISING, [](auto &ctx) {
-		switch (glfwGetInputMode(ctx.window, GLFW_CURSOR)) {
-			case GLFW_CURSOR_DISABLED:
-				glfwSetInputMode(ctx.window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-				break;
-			case GLFW_CURSOR_NORMAL:
-				glfwSetInputMode(ctx.window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-				break;
-		}
-		ctx.input->resetFirstMouse();
-	});
-	input->addKeyCallback(GLFW_KEY_R, RISING, [](auto &ctx) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-	});
-	input->addKeyCallback(GLFW_KEY_F, RISING, [](auto &ctx) {
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-	});
-	input->addCursorPosCallback([mainCameraComponent, mainCameraTransform](auto &ctx, auto xOffset, auto yOffset) mutable {
-		mainCameraComponent->processCursor(mainCameraTransform, xOffset, yOffset, ctx.time.delta);
-	});
+	Transform mainCameraTransform;
+	Camera mainCameraComponent(mainCameraTransform);
+	mainCameraComponent.setMain(true);
+	scene.addComponent(mainCamera, mainCameraTransform);
+	scene.addComponent(mainCamera, mainCameraComponent);
 
 	auto globalShader = compileShader("res/globalVertex.glsl", "res/globalFrag.glsl");
 	auto lightSourceShader = compileShader("res/lightSourceVertex.glsl", "res/lightSourceFrag.glsl");
 
-	globalShader->uniformFloat("material.shininess", 32.0f);
-
 	const glm::vec3 LIGHT_SOURCE_POSITIONS[] = {
 		glm::vec3( 0.7f,  0.2f,  2.0f),
 		glm::vec3( 2.3f, -3.3f, -4.0f),
@@ -148,10 +187,12 @@ void Context::loop() {
 	auto backpack = scene.createEntity();
 	auto backpackModel = loadModel("res/backpack/backpack.obj");
 	Transform backpackTransform;
-	backpackTransform.scale = glm::vec3(0.5f);
-	backpack->addComponent(backpackTransform);
-	backpack->addComponent(backpackModel);
-	backpack->addComponent(globalShader);
+	backpackTransform.setScale(glm::vec3(0.5f));
+	scene.addComponent(backpack, backpackTransform);
+	scene.addComponent(backpack, backpackModel);
+	scene.addComponent(backpack, globalShader);
+	scene.addComponent(backpack, Static {});
+	scene.addComponent(backpack, Occluder {});
 
 	auto directionalLight = scene.createEntity();
 	Transform directionalLightTransform(glm::vec3(0.0f), glm::vec3(-65.0f, -90.0f, 0.0f));
@@ -159,92 +200,262 @@ void Context::loop() {
 	directionalLightComponent.ambient = glm::vec3(0.05f);
 	directionalLightComponent.diffuse = glm::vec3(0.4f);
 	directionalLightComponent.specular = glm::vec3(0.5f);
-	directionalLight->addComponent(directionalLightTransform);
-	directionalLight->addComponent(directionalLightComponent);
-
-	auto sphereModel = loadModel("res/only_quad_sphere.obj");
-	for (int i = 0; i < 4; i++) {
-		auto pointLight = scene.createEntity();
-		Transform pointLightTransform(LIGHT_SOURCE_POSITIONS[i]);
-		pointLightTransform.scale = glm::vec3(0.2f);
-		Light pointLightComponent(POINT);
-		pointLight->addComponent(pointLightTransform);
-		pointLight->addComponent(sphereModel);
-		pointLight->addComponent(lightSourceShader);
-		pointLight->addComponent(pointLightComponent);
+	scene.addComponent(directionalLight, directionalLightTransform);
+	scene.addComponent(directionalLight, directionalLightComponent);
+
+	Transform pointLightTransform;
+	pointLightTransform.setScale(glm::vec3(0.2f));
+	Prefab pointLightPrefab;
+	pointLightPrefab
+		.with(pointLightTransform)
+		.with(loadModel("res/only_quad_sphere.obj"))
+		.with(lightSourceShader)
+		.with(Light(POINT));
+
+	auto pointLights = scene.instantiate(pointLightPrefab, 4);
+	for (size_t i = 0; i < pointLights.size(); i++)
+		scene.getComponent<Transform>(pointLights[i])->setPosition(LIGHT_SOURCE_POSITIONS[i]);
+}
+
+void Context::loop() {
+	Scene scene;
+
+	Snapshot snapshot;
+	snapshot.registerComponent<Transform>("Transform");
+	snapshot.registerComponent<Camera>("Camera");
+	snapshot.registerComponent<Light>("Light");
+	snapshot.registerComponent<Occluder>("Occluder");
+	snapshot.registerComponent<Static>("Static");
+	snapshot.registerAsset<Model>(
+		"Model",
+		[this](const Model &model) { return models.keyOf(&model).value(); },
+		[this](const std::string &path) { return loadModel(path); }
+	);
+	snapshot.registerAsset<ShaderProgram>(
+		"ShaderProgram",
+		[this](const ShaderProgram &shader) { return shaders.keyOf(&shader).value(); },
+		[this](const std::string &id) {
+			auto separator = id.find(':');
+			return compileShader(id.substr(0, separator), id.substr(separator + 1));
+		}
+	);
+
+	// A missing or unreadable snapshot is rewritten from `populateScene`.
+	if (snapshotPath.empty()) {
+		populateScene(scene);
+	} else if (!std::ifstream(snapshotPath)) {
+		populateScene(scene);
+		snapshot.save(scene, snapshotPath);
+	} else {
+		try {
+			snapshot.load(scene, snapshotPath);
+		} catch (const std::runtime_error &error) {
+			std::cerr << error.what() << " Rebuilding it from the default scene." << std::endl;
+			scene = Scene();
+			populateScene(scene);
+			snapshot.save(scene, snapshotPath);
+		}
 	}
 
+	Entity mainCamera;
+	scene.view<Camera>().each([&](Entity entity, Camera &camera) {
+		if (camera.isMain()) mainCamera = entity;
+	});
+	if (!scene.isAlive(mainCamera)) throw std::runtime_error("Scene has no main camera.");
+
+	auto globalShader = compileShader("res/globalVertex.glsl", "res/globalFrag.glsl");
+	auto globalInstancedShader = compileShader("res/globalInstancedVertex.glsl", "res/globalFrag.glsl");
+	auto lightSourceShader = compileShader("res/lightSourceVertex.glsl", "res/lightSourceFrag.glsl");
+	auto lightSourceInstancedShader = compileShader("res/lightSourceInstancedVertex.glsl", "res/lightSourceFrag.glsl");
+	globalShader->uniformFloat("material.shininess", 32.0f);
+	globalInstancedShader->uniformFloat("material.shininess", 32.0f);
+
+	std::shared_ptr<ShaderProgram> gBufferShader, gBufferInstancedShader, deferredLightShader;
+	std::unique_ptr<GBuffer> gBuffer;
+	if (renderPath == DEFERRED_SHADING) {
+		gBufferShader = compileShader("res/globalVertex.glsl", "res/gBufferFrag.glsl");
+		gBufferInstancedShader = compileShader("res/globalInstancedVertex.glsl", "res/gBufferFrag.glsl");
+		deferredLightShader = compileShader("res/deferredLightVertex.glsl", "res/deferredLightFrag.glsl");
+		gBufferShader->uniformFloat("material.shininess", 32.0f);
+		gBufferInstancedShader->uniformFloat("material.shininess", 32.0f);
+		deferredLightShader->uniformInt("gAlbedo", TEXTURE_UNIT_G_ALBEDO);
+		deferredLightShader->uniformInt("gSpecular", TEXTURE_UNIT_G_SPECULAR);
+		deferredLightShader->uniformInt("gNormal", TEXTURE_UNIT_G_NORMAL);
+		deferredLightShader->uniformInt("gDepth", TEXTURE_UNIT_G_DEPTH);
+		gBuffer = std::make_unique<GBuffer>(glState);
+	}
+
+	auto moveCamera = [&scene, mainCamera](CameraDirection dir) {
+		return [&scene, mainCamera, dir](auto &ctx) {
+			scene.getComponent<Camera>(mainCamera)->move(*scene.getComponent<Transform>(mainCamera), dir, ctx.time.delta);
+			scene.markChanged<Transform>(mainCamera);
+		};
+	};
+
+	input->addKeyCallback(GLFW_KEY_ESCAPE, PRESS, [](auto &ctx) { glfwSetWindowShouldClose(ctx.window, true); });
+	input->addKeyCallback(GLFW_KEY_W, PRESS, moveCamera(FORWARD));
+	input->addKeyCallback(GLFW_KEY_S, PRESS, moveCamera(BACKWARD));
+	input->addKeyCallback(GLFW_KEY_A, PRESS, moveCamera(LEFT));
+	input->addKeyCallback(GLFW_KEY_D, PRESS, moveCamera(RIGHT));
+	input->addKeyCallback(GLFW_KEY_SPACE, PRESS, moveCamera(UP));
+	input->addKeyCallback(GLFW_KEY_LEFT_SHIFT, PRESS, moveCamera(DOWN));
+	input->addKeyCallback(GLFW_KEY_Q, RISING, [](auto &ctx) {
+		switch (glfwGetInputMode(ctx.window, GLFW_CURSOR)) {
+			case GLFW_CURSOR_DISABLED:
+				glfwSetInputMode(ctx.window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+				break;
+			case GLFW_CURSOR_NORMAL:
+				glfwSetInputMode(ctx.window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+				break;
+		}
+		ctx.input->resetFirstMouse();
+	});
+	input->addKeyCallback(GLFW_KEY_R, RISING, [](auto &ctx) {
+		ctx.glState.setPolygonMode(GL_LINE);
+	});
+	input->addKeyCallback(GLFW_KEY_F, RISING, [](auto &ctx) {
+		ctx.glState.setPolygonMode(GL_FILL);
+	});
+	input->addCursorPosCallback([&scene, mainCamera](auto &ctx, auto xOffset, auto yOffset) {
+		scene.getComponent<Camera>(mainCamera)->processCursor(*scene.getComponent<Transform>(mainCamera), xOffset, yOffset, ctx.time.delta);
+		scene.markChanged<Transform>(mainCamera);
+	});
+
+	// One pool for the scheduler and every subsystem, so threads never outnumber cores.
+	ThreadPool pool;
+	FrameCamera frameCamera;
+	FrameLights frameLights;
+	UniformBuffer cameraUniforms(UNIFORM_BINDING_CAMERA, sizeof(CameraUniforms));
+	UniformBuffer lightUniforms(UNIFORM_BINDING_LIGHTS, sizeof(LightUniforms));
+	UniformBuffer clusterUniforms(UNIFORM_BINDING_CLUSTERS, sizeof(ClusterUniforms));
+	BufferTexture clusterLights(glState, TEXTURE_UNIT_CLUSTER_LIGHTS, GL_RGBA32F, sizeof(glm::vec4));
+	BufferTexture clusterGrid(glState, TEXTURE_UNIT_CLUSTER_GRID, GL_RG32UI, sizeof(glm::uvec2));
+	BufferTexture clusterIndices(glState, TEXTURE_UNIT_CLUSTER_INDICES, GL_R32UI, sizeof(uint32_t));
+	LightClusters lightClusters(&pool);
+	FrustumCuller culler;
+	RenderQueue renderQueue;
+	renderQueue.setInstancedVariant(*globalShader, *globalInstancedShader);
+	renderQueue.setInstancedVariant(*lightSourceShader, *lightSourceInstancedShader);
+	if (renderPath == DEFERRED_SHADING) {
+		renderQueue.setSubstitute(*globalShader, *gBufferShader);
+		renderQueue.setInstancedVariant(*gBufferShader, *gBufferInstancedShader);
+	}
+	TransformHierarchy hierarchy(&pool);
+	SceneBVH sceneBVH(&pool);
+	OcclusionBuffer occlusion(&pool);
+
+	Scheduler scheduler(pool);
+	scheduler.addSystem<Read<Camera, Transform>, Write<FrameCamera>>("camera", [this, &frameCamera](Scene &scene, CommandBuffer &, Tick) {
+		scene.view<Camera, Transform>().each([&](Entity, Camera &camera, Transform &transform) {
+			if (!camera.isMain()) return;
+			frameCamera.view = camera.getViewMatrix(transform);
+			frameCamera.projection = glm::perspective(
+				glm::radians(45.0f),
+				static_cast<float>(screen.width) / static_cast<float>(screen.height),
+				0.1f,
+				100.0f
+			);
+		});
+	});
+	scheduler.addSystem<Read<Transform, Parent>, Write<TransformHierarchy>>("hierarchy", [&hierarchy](Scene &scene, CommandBuffer &, Tick lastRun) {
+		hierarchy.update(scene, lastRun);
+	});
+	scheduler.addSystem<Read<Static, Transform, Model, TransformHierarchy>, Write<SceneBVH>>("bvh", [&sceneBVH, &hierarchy](Scene &scene, CommandBuffer &, Tick lastRun) {
+		sceneBVH.update(scene, hierarchy, lastRun);
+	});
+	scheduler.addSystem<Read<Occluder, Transform, Model, TransformHierarchy, FrameCamera>, Write<OcclusionBuffer>>("occluders", [&occlusion, &hierarchy, &frameCamera](Scene &scene, CommandBuffer &, Tick) {
+		occlusion.clear();
+		auto viewProjection = frameCamera.projection * frameCamera.view;
+		scene.view<Occluder, Transform, Model>().each([&](Entity entity, Occluder &, Transform &, Model &model) {
+			auto modelViewProjection = viewProjection * hierarchy.getWorldMatrix(entity);
+			for (const auto &mesh : model.getMeshes()) occlusion.addOccluder(mesh->vertices, mesh->indices, modelViewProjection);
+		});
+		occlusion.rasterize();
+	});
+	scheduler.addSystem<Read<Light, Transform, TransformHierarchy, FrameCamera>, Write<FrameLights, LightClusters>>("lights", [this, &frameLights, &lightClusters, &hierarchy, &frameCamera](Scene &scene, CommandBuffer &, Tick) {
+		frameLights.uniforms.nDirectionalLights = 0;
+		frameLights.localLights.clear();
+		scene.view<Light, Transform>().each([&](Entity entity, Light &light, Transform &transform) {
+			light.store(frameLights.uniforms, frameLights.localLights, transform, hierarchy.getWorldMatrix(entity), frameCamera.view);
+		});
+
+		frameLights.spheres.clear();
+		for (const auto &light : frameLights.localLights) frameLights.spheres.push_back(glm::vec4(light.position, light.range));
+		lightClusters.setProjection(frameCamera.projection, screen.width, screen.height);
+		lightClusters.assign(frameLights.spheres);
+	});
+	scheduler.addSystem<Read<Transform, Model, ShaderProgram, TransformHierarchy, SceneBVH, OcclusionBuffer, FrameCamera>, Write<RenderQueue>>("draws", [&culler, &renderQueue, &hierarchy, &sceneBVH, &occlusion, &frameCamera](Scene &scene, CommandBuffer &, Tick) {
+		culler.clear();
+		sceneBVH.queryFrustum(Frustum(frameCamera.projection * frameCamera.view), [&](Entity entity, bool inside) {
+			auto *shader = scene.getComponent<ShaderProgram>(entity);
+			if (!shader) return;
+			culler.addVisible(*scene.getComponent<Model>(entity), *shader, hierarchy.getWorldMatrix(entity), hierarchy.getNormalMatrix(entity), inside);
+		});
+		scene.view<Transform, Model, ShaderProgram>().each([&](Entity entity, Transform &, Model &model, ShaderProgram &shader) {
+			if (sceneBVH.contains(entity)) return;
+			culler.add(model, shader, hierarchy.getWorldMatrix(entity), hierarchy.getNormalMatrix(entity));
+		});
+
+		renderQueue.clear();
+		culler.cull(frameCamera.view, frameCamera.projection, renderQueue, &occlusion);
+		renderQueue.sort();
+	});
+
+	float statsSince = 0.0f;
+	size_t statsFrames = 0;
 	while (!glfwWindowShouldClose(window)) {
 		time.now = static_cast<float>(glfwGetTime());
 		time.delta = time.now - time.last;
 		time.last = time.now;
 
+		glState.resetStats();
 		processFramebufferSize();
 		input->process();
+		scheduler.run(scene);
 
 		// Render
-		glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// Get lights
-		std::vector<std::pair<std::shared_ptr<Light>, std::shared_ptr<Transform>>> lights;
-		for (const auto &entity : scene.getActiveEntities()) {
-			auto lightOpt = entity->getComponent<Light>();
-			if (lightOpt) {
-				auto transform = entity->getComponent<Transform>().value();
-				lights.push_back({lightOpt.value(), transform});
-			}
+		cameraUniforms.update(CameraUniforms {
+			.view = frameCamera.view,
+			.projection = frameCamera.projection,
+			.inverseProjection = glm::inverse(frameCamera.projection),
+		});
+		lightUniforms.update(frameLights.uniforms);
+		clusterUniforms.update(ClusterUniforms {
+			.counts = glm::ivec3(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z),
+			.padding = 0,
+			.tileSize = lightClusters.getTileSize(),
+			.depthScale = lightClusters.getDepthScale(),
+			.depthBias = lightClusters.getDepthBias(),
+		});
+		clusterLights.update(frameLights.localLights.data(), frameLights.localLights.size() * sizeof(LocalLightTexels));
+		clusterGrid.update(lightClusters.getGrid().data(), lightClusters.getGrid().size() * sizeof(glm::uvec2));
+		clusterIndices.update(lightClusters.getIndices().data(), lightClusters.getIndices().size() * sizeof(uint32_t));
+
+		if (renderPath == DEFERRED_SHADING) {
+			// Unlit draws such as light sources go forward on top of the light pass.
+			auto isGeometryPass = [&](const ShaderProgram &shader) { return &shader == gBufferShader.get(); };
+			gBuffer->resize(screen.width, screen.height);
+			gBuffer->bind();
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			renderQueue.submit(glState, isGeometryPass);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			gBuffer->drawLightPass(*deferredLightShader);
+			gBuffer->blitDepth();
+			renderQueue.submit(glState, [&](const ShaderProgram &shader) { return !isGeometryPass(shader); });
+		} else {
+			glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			renderQueue.submit(glState);
 		}
 
-		auto view = mainCameraComponent->getViewMatrix(mainCameraTransform);
-		auto projection = glm::perspective(
-			glm::radians(45.0f),
-			static_cast<float>(screen.width) / static_cast<float>(screen.height),
-			0.1f,
-			100.0f
-		);
-
-		for (const auto &entity : scene.getActiveEntities()) {
-			auto modelOpt = entity->getComponent<Model>();
-			if (modelOpt) {
-				auto model = modelOpt.value();
-				auto transform = entity->getComponent<Transform>().value();
-				auto shader = entity->getComponent<ShaderProgram>().value();
-
-				unsigned int nDirectional = 0;
-				unsigned int nPoint = 0;
-				unsigned int nSpot = 0;
-				for (const auto &[light, lightTransform] : lights) {
-					switch (light->type) {
-						case DIRECTIONAL:
-							light->use(shader, lightTransform, view, nDirectional++);
-							break;
-						case POINT:
-							light->use(shader, lightTransform, view, nPoint++);
-							break;
-						case SPOT:
-							light->use(shader, lightTransform, view, nSpot++);
-							break;
-					}
-				}
-				shader->tryUniformInt("nDirectionalLights", nDirectional);
-				shader->tryUniformInt("nPointLights", nPoint);
-				shader->tryUniformInt("nSpotLights", nSpot);
-
-				shader->uniformMat4("view", view);
-				shader->uniformMat4("projection", projection);
-
-				glm::mat4 modelMat(1.0f);
-				modelMat = glm::translate(modelMat, transform->position);
-				modelMat = glm::rotate(modelMat, glm::radians(transform->rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-				modelMat = glm::rotate(modelMat, glm::radians(transform->rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-				modelMat = glm::rotate(modelMat, glm::radians(transform->rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-				modelMat = glm::scale(modelMat, transform->scale);
-				shader->uniformMat4("model", modelMat);
-				shader->tryUniformMat3("normalMatrix", glm::mat3(glm::transpose(glm::inverse(modelMat))));
-
-				model->draw(shader);
-			}
+		statsFrames++;
+		if (time.now - statsSince >= STATS_INTERVAL) {
+			glfwSetWindowTitle(window, statsTitle(statsFrames / (time.now - statsSince), culler.getStats(), renderQueue.getStats(), glState.getStats()).c_str());
+			statsSince = time.now;
+			statsFrames = 0;
 		}
 
 		glfwSwapBuffers(window);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "graphics/gl_state.hpp"
 #include "util/cache.hpp"
 
 #include <glad/glad.h>
@@ -11,16 +12,23 @@
 
 class InputManager;
 class Model;
+class Scene;
 class ShaderProgram;
 class Texture;
 
 const unsigned int INITIAL_WINDOW_WIDTH = 800;
 const unsigned int INITIAL_WINDOW_HEIGHT = 600;
 
+enum RenderPath {
+	FORWARD_SHADING,
+	DEFERRED_SHADING,
+};
+
 class Context {
 	private:
 		void processFramebufferSize();
 		void processCursorPos();
+		void populateScene(Scene &scene);
 
 	public:
 		struct {
@@ -34,13 +42,16 @@ class Context {
 			float last;
 		} time;
 
+		RenderPath renderPath;
+		std::string snapshotPath;
 		GLFWwindow *window;
 		std::unique_ptr<InputManager> input;
+		GLState glState {};
 		Cache<std::string, Texture> textures {};
 		Cache<std::string, ShaderProgram> shaders {};
 		Cache<std::string, Model> models {};
 
-		Context();
+		Context(RenderPath renderPath = FORWARD_SHADING, const std::string &snapshotPath = "");
 		~Context();
 
 		std::shared_ptr<ShaderProgram> compileShader(const std::string &vertexSourcePath, const std::string &fragmentSourcePath);
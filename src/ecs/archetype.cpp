@@ -0,0 +1,169 @@
+#include "archetype.hpp"
+
+#include "prefab.hpp"
+#include <stdexcept>
+
+size_t alignUp(size_t offset, size_t align) {
+	return (offset + align - 1) / align * align;
+}
+
+Archetype::Archetype(Signature signature, const std::vector<ComponentInfo> &infos) : signature(signature) {
+	columnIndex.fill(-1);
+
+	size_t rowSize = sizeof(Entity);
+	for (ComponentType type = 0; type < MAX_COMPONENTS; type++) {
+		if (!signature.test(type)) continue;
+		const auto &info = infos[type];
+		if (info.align > ARCHETYPE_CHUNK_ALIGN)
+			throw std::invalid_argument("Component alignment exceeds the archetype chunk alignment.");
+
+		columnIndex[type] = columns.size();
+		columns.push_back({ .type = type, .info = info, .offset = 0, .ticksOffset = 0 });
+		rowSize += info.size + sizeof(ComponentTicks);
+	}
+
+	for (capacity = ARCHETYPE_CHUNK_SIZE / rowSize; capacity > 0; capacity--) {
+		size_t offset = sizeof(Entity) * capacity;
+		for (auto &column : columns) {
+			column.offset = alignUp(offset, column.info.align);
+			offset = column.offset + column.info.size * capacity;
+		}
+		for (auto &column : columns) {
+			column.ticksOffset = alignUp(offset, alignof(ComponentTicks));
+			offset = column.ticksOffset + sizeof(ComponentTicks) * capacity;
+		}
+		if (offset <= ARCHETYPE_CHUNK_SIZE) break;
+	}
+
+	if (capacity == 0)
+		throw std::invalid_argument("Components do not fit in an archetype chunk.");
+}
+
+Archetype::~Archetype() {
+	for (size_t chunk = 0; chunk < chunks.size(); chunk++) {
+		for (size_t row = 0; row < chunks[chunk]->count; row++)
+			destroyRow({ .chunk = chunk, .row = row });
+	}
+}
+
+Archetype::Location Archetype::push(Entity entity) {
+	if (chunks.empty() || chunks.back()->count == capacity)
+		chunks.push_back(std::make_unique<Chunk>());
+
+	auto chunk = chunks.size() - 1;
+	auto row = chunks[chunk]->count++;
+	entities(chunk)[row] = entity;
+	return { .chunk = chunk, .row = row };
+}
+
+void Archetype::moveRow(Location from, Archetype &to, Location location) {
+	for (const auto &column : columns) {
+		auto *component = get(column.type, from.chunk, from.row);
+		if (to.has(column.type)) {
+			column.info.move(to.get(column.type, location.chunk, location.row), component);
+			to.ticks(column.type, location.chunk)[location.row] = ticks(column.type, from.chunk)[from.row];
+		} else {
+			column.info.destroy(component);
+		}
+	}
+}
+
+void Archetype::destroyRow(Location location) {
+	for (const auto &column : columns)
+		column.info.destroy(get(column.type, location.chunk, location.row));
+}
+
+Entity Archetype::removeRow(Location location) {
+	auto lastChunk = chunks.size() - 1;
+	auto lastRow = chunks[lastChunk]->count - 1;
+	Entity moved;
+
+	if (location.chunk != lastChunk || location.row != lastRow) {
+		for (const auto &column : columns) {
+			column.info.move(get(column.type, location.chunk, location.row), get(column.type, lastChunk, lastRow));
+			ticks(column.type, location.chunk)[location.row] = ticks(column.type, lastChunk)[lastRow];
+		}
+		moved = entities(lastChunk)[lastRow];
+		entities(location.chunk)[location.row] = moved;
+	}
+
+	if (--chunks[lastChunk]->count == 0) chunks.pop_back();
+	return moved;
+}
+
+ArchetypeManager::EntityLocation &ArchetypeManager::getLocation(Entity entity) {
+	if (entity.id >= locations.size()) locations.resize(entity.id + 1);
+	auto &location = locations[entity.id];
+	if (!location.archetype) location.generation = entity.generation;
+	return location;
+}
+
+Archetype &ArchetypeManager::getArchetype(Signature signature) {
+	auto it = archetypes.find(signature);
+	if (it != archetypes.end()) return *it->second;
+
+	auto &archetype = archetypes[signature] = std::make_unique<Archetype>(signature, componentInfos);
+	for (auto &[querySignature, query] : queries) {
+		if ((signature & querySignature) == querySignature) query->push_back(archetype.get());
+	}
+	return *archetype;
+}
+
+std::vector<Archetype *> &ArchetypeManager::getQuery(Signature signature) {
+	auto it = queries.find(signature);
+	if (it != queries.end()) return *it->second;
+
+	auto query = std::make_unique<std::vector<Archetype *>>();
+	for (const auto &[archetypeSignature, archetype] : archetypes) {
+		if ((archetypeSignature & signature) == signature) query->push_back(archetype.get());
+	}
+	return *(queries[signature] = std::move(query));
+}
+
+ArchetypeManager::EntityLocation &ArchetypeManager::moveEntity(Entity entity, Signature signature) {
+	auto *to = signature.any() ? &getArchetype(signature) : nullptr;
+	auto &current = getLocation(entity);
+
+	Archetype::Location location {};
+	if (to) location = to->push(entity);
+
+	if (current.archetype) {
+		if (to) current.archetype->moveRow(current.location, *to, location);
+		else current.archetype->destroyRow(current.location);
+
+		auto moved = current.archetype->removeRow(current.location);
+		if (moved.id != INVALID_ENTITY) locations[moved.id].location = current.location;
+	}
+
+	current.archetype = to;
+	current.location = location;
+	return current;
+}
+
+void ArchetypeManager::instantiate(const Prefab &prefab, const std::vector<Entity> &entities) {
+	auto signature = prefab.getSignature();
+	if (signature.none()) return;
+
+	auto &archetype = getArchetype(signature);
+	for (auto entity : entities) {
+		auto &current = getLocation(entity);
+		auto location = archetype.push(entity);
+		for (const auto &component : prefab.getComponents()) {
+			auto type = component->getType();
+			component->copyTo(archetype.get(type, location.chunk, location.row));
+			archetype.ticks(type, location.chunk)[location.row] = { .added = tick, .changed = tick };
+		}
+
+		current.archetype = &archetype;
+		current.location = location;
+	}
+}
+
+void ArchetypeManager::onEntityDestroyed(Entity entity) {
+	if (entity.id >= locations.size() || !locations[entity.id].archetype) return;
+	moveEntity(entity, Signature());
+}
+
+void ArchetypeManager::onEntitiesDestroyed(const std::vector<Entity> &entities) {
+	for (auto entity : entities) onEntityDestroyed(entity);
+}
@@ -0,0 +1,321 @@
+#pragma once
+
+#include "../util/paged_vector.hpp"
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Prefab;
+
+const size_t ARCHETYPE_CHUNK_SIZE = 16 * 1024;
+const size_t ARCHETYPE_CHUNK_ALIGN = 64;
+
+struct ComponentInfo {
+	size_t size = 0;
+	size_t align = 0;
+	void (*move)(void *dst, void *src) = nullptr; // move-constructs dst, destroys src
+	void (*destroy)(void *component) = nullptr;
+};
+
+template <typename T>
+ComponentInfo componentInfoOf() {
+	using Storage = ComponentStorage<T>;
+	ComponentInfo info;
+	info.size = sizeof(Storage);
+	info.align = alignof(Storage);
+	info.move = [](void *dst, void *src) {
+		auto *component = static_cast<Storage *>(src);
+		new (dst) Storage(std::move(*component));
+		component->~Storage();
+	};
+	info.destroy = [](void *component) { static_cast<Storage *>(component)->~Storage(); };
+	return info;
+}
+
+class Archetype {
+	private:
+		struct Chunk {
+			alignas(ARCHETYPE_CHUNK_ALIGN) unsigned char data[ARCHETYPE_CHUNK_SIZE];
+			size_t count = 0;
+		};
+
+		struct Column {
+			ComponentType type;
+			ComponentInfo info;
+			size_t offset;
+			size_t ticksOffset;
+		};
+
+		Signature signature;
+		std::vector<Column> columns {};
+		std::array<int, MAX_COMPONENTS> columnIndex {};
+		std::vector<std::unique_ptr<Chunk>> chunks {};
+		size_t capacity = 0;
+
+		Entity *entities(size_t chunk) const { return reinterpret_cast<Entity *>(chunks[chunk]->data); };
+
+	public:
+		struct Location {
+			size_t chunk;
+			size_t row;
+		};
+
+		Archetype(Signature signature, const std::vector<ComponentInfo> &infos);
+		~Archetype();
+
+		Signature getSignature() const { return signature; };
+		bool has(ComponentType type) const { return columnIndex[type] != -1; };
+
+		size_t chunkCount() const { return chunks.size(); };
+		size_t rowCount(size_t chunk) const { return chunks[chunk]->count; };
+		Entity getEntity(size_t chunk, size_t row) const { return entities(chunk)[row]; };
+
+		void *get(ComponentType type, size_t chunk, size_t row) const {
+			const auto &column = columns[columnIndex[type]];
+			return chunks[chunk]->data + column.offset + row * column.info.size;
+		};
+
+		ComponentTicks *ticks(ComponentType type, size_t chunk) const {
+			return reinterpret_cast<ComponentTicks *>(chunks[chunk]->data + columns[columnIndex[type]].ticksOffset);
+		};
+
+		template <typename T>
+		ComponentStorage<T> *column(size_t chunk) const {
+			return static_cast<ComponentStorage<T> *>(get(componentType<T>(), chunk, 0));
+		};
+
+		// Reserves a row whose components are left unconstructed.
+		Location push(Entity entity);
+		void moveRow(Location from, Archetype &to, Location location);
+		void destroyRow(Location location);
+		Entity removeRow(Location location);
+};
+
+template <typename... Ts>
+class ArchetypeView {
+	private:
+		const std::vector<Archetype *> &archetypes;
+
+	public:
+		using Value = std::tuple<Entity, Ts&...>;
+
+		struct Iterator {
+			using value_type = Value;
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category	= std::forward_iterator_tag;
+
+			const std::vector<Archetype *> *archetypes;
+			size_t archetype, chunk, row;
+
+			Iterator(const std::vector<Archetype *> *archetypes, size_t archetype) : archetypes(archetypes), archetype(archetype), chunk(0), row(0) {
+				skipEmpty();
+			};
+
+			void skipEmpty() {
+				while (archetype < archetypes->size()) {
+					auto *current = (*archetypes)[archetype];
+					if (chunk < current->chunkCount() && row < current->rowCount(chunk)) return;
+					if (chunk < current->chunkCount()) {
+						chunk++;
+					} else {
+						archetype++;
+						chunk = 0;
+					}
+					row = 0;
+				}
+			};
+
+			reference operator*() const {
+				auto *current = (*archetypes)[archetype];
+				return Value(
+					current->getEntity(chunk, row),
+					*componentPointer<Ts>(*static_cast<ComponentStorage<Ts> *>(current->get(componentType<Ts>(), chunk, row)))...
+				);
+			};
+
+			Iterator& operator++() { row++; skipEmpty(); return *this; };
+			Iterator operator++(int) { Iterator i(*this); ++(*this); return i; };
+
+			bool operator==(const Iterator &rhs) const { return archetype == rhs.archetype && chunk == rhs.chunk && row == rhs.row; };
+			bool operator!=(const Iterator &rhs) const { return !(*this == rhs); };
+		};
+
+		ArchetypeView(const std::vector<Archetype *> &archetypes) : archetypes(archetypes) {};
+
+		size_t size() const {
+			size_t n = 0;
+			for (const auto *archetype : archetypes) {
+				for (size_t chunk = 0; chunk < archetype->chunkCount(); chunk++)
+					n += archetype->rowCount(chunk);
+			}
+			return n;
+		};
+		bool empty() const { return size() == 0; };
+
+		Iterator begin() const { return Iterator(&archetypes, 0); };
+		Iterator end() const { return Iterator(&archetypes, archetypes.size()); };
+
+		template <typename F>
+		void each(F &&fn) const {
+			for (auto *archetype : archetypes) {
+				for (size_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+					auto columns = std::make_tuple(archetype->column<Ts>(chunk)...);
+					for (size_t row = 0; row < archetype->rowCount(chunk); row++)
+						fn(archetype->getEntity(chunk, row), *componentPointer<Ts>(std::get<ComponentStorage<Ts> *>(columns)[row])...);
+				}
+			}
+		};
+
+		template <typename Filter, typename F>
+		void each(const Filter &filter, F &&fn) const {
+			using Component = typename Filter::Component;
+			static_assert((std::is_same_v<Component, Ts> || ...), "Filtered component must be part of the view.");
+
+			for (auto *archetype : archetypes) {
+				for (size_t chunk = 0; chunk < archetype->chunkCount(); chunk++) {
+					auto columns = std::make_tuple(archetype->column<Ts>(chunk)...);
+					auto *ticks = archetype->ticks(componentType<Component>(), chunk);
+					for (size_t row = 0; row < archetype->rowCount(chunk); row++) {
+						if (!filter.matches(ticks[row])) continue;
+						fn(archetype->getEntity(chunk, row), *componentPointer<Ts>(std::get<ComponentStorage<Ts> *>(columns)[row])...);
+					}
+				}
+			}
+		};
+};
+
+class ArchetypeManager {
+	private:
+		struct EntityLocation {
+			Archetype *archetype = nullptr;
+			Archetype::Location location;
+			EntityGeneration generation = 0;
+		};
+
+		std::vector<ComponentInfo> componentInfos {};
+		std::unordered_map<Signature, std::unique_ptr<Archetype>> archetypes {};
+		std::unordered_map<Signature, std::unique_ptr<std::vector<Archetype *>>> queries {};
+		std::mutex queryMutex {};
+		PagedVector<EntityLocation> locations {};
+		Tick tick = 1;
+
+		EntityLocation &getLocation(Entity entity);
+		Archetype &getArchetype(Signature signature);
+		std::vector<Archetype *> &getQuery(Signature signature);
+		EntityLocation &moveEntity(Entity entity, Signature signature);
+
+		template <typename T>
+		ComponentStorage<T> *getStorage(Entity entity) {
+			if (entity.id >= locations.size()) return nullptr;
+			auto &entityLocation = locations[entity.id];
+			auto type = componentType<T>();
+			if (entityLocation.generation != entity.generation) return nullptr;
+			if (!entityLocation.archetype || !entityLocation.archetype->has(type)) return nullptr;
+			auto [chunk, row] = entityLocation.location;
+			return static_cast<ComponentStorage<T> *>(entityLocation.archetype->get(type, chunk, row));
+		};
+
+		template <typename T>
+		ComponentTicks *getTicks(Entity entity) {
+			if (!getStorage<T>(entity)) return nullptr;
+			auto [chunk, row] = locations[entity.id].location;
+			return &locations[entity.id].archetype->ticks(componentType<T>(), chunk)[row];
+		};
+
+	public:
+		template <typename T>
+		void registerComponent() {
+			auto type = componentType<T>();
+			if (type >= MAX_COMPONENTS)
+				throw std::length_error("Component limit exceeded.");
+			if (type >= componentInfos.size()) componentInfos.resize(type + 1);
+			if (!componentInfos[type].size) componentInfos[type] = componentInfoOf<T>();
+		};
+
+		template <typename T>
+		void addComponent(Entity entity, ComponentStorage<T> component) {
+			registerComponent<T>();
+			auto &current = getLocation(entity);
+			if (current.archetype && current.archetype->has(componentType<T>()))
+				throw std::runtime_error("Entity " + std::to_string(entity.id) + " already has a(n) `" + typeid(T).name() + "` component.");
+
+			auto signature = current.archetype ? current.archetype->getSignature() : Signature();
+			auto &moved = moveEntity(entity, signature.set(componentType<T>()));
+			auto [chunk, row] = moved.location;
+			new (moved.archetype->get(componentType<T>(), chunk, row)) ComponentStorage<T>(std::move(component));
+			moved.archetype->ticks(componentType<T>(), chunk)[row] = { .added = tick, .changed = tick };
+		};
+
+		template <typename T>
+		void addComponents(std::vector<std::pair<Entity, ComponentStorage<T>>> &components) {
+			for (auto &[entity, component] : components) addComponent<T>(entity, std::move(component));
+		};
+
+		template <typename T>
+		void removeComponents(const std::vector<Entity> &entities) {
+			for (auto entity : entities) {
+				if (!getStorage<T>(entity))
+					throw std::runtime_error("Entity " + std::to_string(entity.id) + " does not have a(n) `" + typeid(T).name() + "` component.");
+			}
+			for (auto entity : entities) removeComponent<T>(entity);
+		};
+
+		template <typename T>
+		void removeComponent(Entity entity) {
+			if (!getStorage<T>(entity))
+				throw std::runtime_error("Entity " + std::to_string(entity.id) + " does not have a(n) `" + typeid(T).name() + "` component.");
+
+			auto signature = locations[entity.id].archetype->getSignature();
+			moveEntity(entity, signature.reset(componentType<T>()));
+		};
+
+		template <typename T>
+		T *getComponent(Entity entity) {
+			auto *storage = getStorage<T>(entity);
+			if (!storage) return nullptr;
+			return componentPointer<T>(*storage);
+		};
+
+		template <typename T>
+		void markChanged(Entity entity) {
+			auto *ticks = getTicks<T>(entity);
+			if (!ticks)
+				throw std::runtime_error("Entity " + std::to_string(entity.id) + " does not have a(n) `" + typeid(T).name() + "` component.");
+			ticks->changed = tick;
+		};
+
+		template <typename T, typename F>
+		void each(F &&fn) {
+			view<T>().each(std::forward<F>(fn));
+		};
+
+		template <typename... Ts>
+		ArchetypeView<Ts...> view() {
+			std::lock_guard lock(queryMutex);
+			(registerComponent<Ts>(), ...);
+			return ArchetypeView<Ts...>(getQuery(signatureOf<Ts...>()));
+		};
+
+		// `entities` must not have any components yet.
+		void instantiate(const Prefab &prefab, const std::vector<Entity> &entities);
+
+		Tick getTick() const { return tick; };
+		Tick advanceTick() { return ++tick; };
+
+		void onEntityDestroyed(Entity entity);
+		void onEntitiesDestroyed(const std::vector<Entity> &entities);
+};
@@ -0,0 +1,62 @@
+#include "command_buffer.hpp"
+
+#include <stdexcept>
+#include <string>
+
+bool CommandBuffer::empty() const {
+	if (nCreated > 0 || !destroyed.empty()) return false;
+	for (const auto &queue : queues) {
+		if (queue) return false;
+	}
+	return true;
+}
+
+void CommandBuffer::append(CommandBuffer &other) {
+	if (other.queues.size() > queues.size()) queues.resize(other.queues.size());
+	for (size_t type = 0; type < other.queues.size(); type++) {
+		if (!other.queues[type]) continue;
+		other.queues[type]->offsetPending(nCreated);
+		if (!queues[type]) queues[type] = std::move(other.queues[type]);
+		else queues[type]->merge(*other.queues[type]);
+	}
+	for (auto entity : other.destroyed) {
+		if (entity.generation == PENDING_GENERATION) entity.id += nCreated;
+		destroyed.push_back(entity);
+	}
+
+	nCreated += other.nCreated;
+	other.queues.clear();
+	other.destroyed.clear();
+	other.nCreated = 0;
+}
+
+void CommandBuffer::clear() {
+	queues.clear();
+	destroyed.clear();
+	nCreated = 0;
+}
+
+void CommandBuffer::playback(Scene &scene) {
+	try {
+		for (auto &queue : queues) {
+			if (queue) queue->fold(scene);
+		}
+		for (auto entity : destroyed) {
+			if (entity.generation != PENDING_GENERATION && !scene.isAlive(entity))
+				throw std::invalid_argument("Entity " + std::to_string(entity.id) + " handle is stale.");
+		}
+	} catch (...) {
+		// Queues folded before the failure have lost their commands.
+		clear();
+		throw;
+	}
+
+	auto created = scene.createEntities(nCreated);
+	for (auto &queue : queues) {
+		if (queue) queue->apply(scene, created);
+	}
+
+	for (auto &entity : destroyed) entity = resolvePending(entity, created);
+	scene.destroyEntities(destroyed);
+	clear();
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "scene.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+const EntityGeneration PENDING_GENERATION = std::numeric_limits<EntityGeneration>::max();
+
+class ICommandQueue {
+	public:
+		virtual ~ICommandQueue() = default;
+		virtual void offsetPending(EntityId offset) = 0;
+		virtual void merge(ICommandQueue &other) = 0;
+		virtual void fold(Scene &scene) = 0;
+		virtual void apply(Scene &scene, const std::vector<Entity> &created) = 0;
+};
+
+inline Entity resolvePending(Entity entity, const std::vector<Entity> &created) {
+	return entity.generation == PENDING_GENERATION ? created[entity.id] : entity;
+}
+
+// Pending ids overlap existing ones, so they sort after them.
+inline bool entityBefore(Entity a, Entity b) {
+	bool aPending = a.generation == PENDING_GENERATION;
+	bool bPending = b.generation == PENDING_GENERATION;
+	return aPending != bPending ? bPending : a.id < b.id;
+}
+
+template <typename T>
+class CommandQueue : public ICommandQueue {
+	private:
+		struct Command {
+			Entity entity;
+			std::optional<ComponentStorage<T>> component;
+		};
+
+		std::vector<Command> commands {};
+		std::vector<std::pair<Entity, ComponentStorage<T>>> adds {};
+		std::vector<Entity> removes {};
+
+	public:
+		void add(Entity entity, ComponentStorage<T> component) { commands.push_back({ entity, std::move(component) }); };
+		void remove(Entity entity) { commands.push_back({ entity, std::nullopt }); };
+
+		void offsetPending(EntityId offset) override {
+			for (auto &command : commands) {
+				if (command.entity.generation == PENDING_GENERATION) command.entity.id += offset;
+			}
+		};
+
+		void merge(ICommandQueue &other) override {
+			auto &queue = static_cast<CommandQueue<T> &>(other);
+			for (auto &command : queue.commands) commands.push_back(std::move(command));
+			queue.commands.clear();
+		};
+
+		// Throws without touching the scene if a command can't apply.
+		void fold(Scene &scene) override {
+			std::stable_sort(commands.begin(), commands.end(), [](const Command &a, const Command &b) { return entityBefore(a.entity, b.entity); });
+			for (size_t first = 0; first < commands.size();) {
+				auto entity = commands[first].entity;
+				bool pending = entity.generation == PENDING_GENERATION;
+				if (!pending && !scene.isAlive(entity))
+					throw std::invalid_argument("Entity " + std::to_string(entity.id) + " handle is stale.");
+
+				bool had = !pending && scene.getComponent<T>(entity);
+				bool has = had;
+				auto last = first;
+				for (; last < commands.size() && commands[last].entity == entity; last++) {
+					bool adding = commands[last].component.has_value();
+					if (adding == has) {
+						throw std::runtime_error("Entity " + std::to_string(entity.id) + (adding ? " already has" : " does not have") +
+							" a(n) `" + typeid(T).name() + "` component.");
+					}
+					has = adding;
+				}
+
+				if (had) removes.push_back(entity);
+				if (has) adds.emplace_back(entity, std::move(*commands[last - 1].component));
+				first = last;
+			}
+			commands.clear();
+		};
+
+		void apply(Scene &scene, const std::vector<Entity> &created) override {
+			if (!removes.empty()) {
+				scene.removeComponents<T>(removes);
+				removes.clear();
+			}
+			if (!adds.empty()) {
+				for (auto &[entity, _] : adds) entity = resolvePending(entity, created);
+				std::sort(adds.begin(), adds.end(), [](const auto &a, const auto &b) { return a.first.id < b.first.id; });
+				scene.addComponents<T>(adds);
+				adds.clear();
+			}
+		};
+};
+
+// Defers structural changes; playback checks everything first and consumes the buffer even if it throws.
+class CommandBuffer {
+	private:
+		std::vector<std::unique_ptr<ICommandQueue>> queues {};
+		std::vector<Entity> destroyed {};
+		EntityId nCreated = 0;
+
+		template <typename T>
+		CommandQueue<T> &getQueue() {
+			auto type = componentType<T>();
+			if (type >= queues.size()) queues.resize(type + 1);
+			if (!queues[type]) queues[type] = std::make_unique<CommandQueue<T>>();
+			return static_cast<CommandQueue<T> &>(*queues[type]);
+		};
+
+	public:
+		Entity createEntity() { return { .id = nCreated++, .generation = PENDING_GENERATION }; };
+		void destroyEntity(Entity entity) { destroyed.push_back(entity); };
+
+		template <typename T>
+		void addComponent(Entity entity, T component) {
+			static_assert(!SharedComponent<T>::value, "Shared components must be added by pointer.");
+			getQueue<T>().add(entity, std::move(component));
+		};
+
+		template <typename T>
+		void addComponent(Entity entity, std::shared_ptr<T> component) {
+			static_assert(SharedComponent<T>::value, "Only shared components can be added by pointer.");
+			getQueue<T>().add(entity, std::move(component));
+		};
+
+		template <typename T>
+		void removeComponent(Entity entity) {
+			getQueue<T>().remove(entity);
+		};
+
+		bool empty() const;
+		void clear();
+		void append(CommandBuffer &other);
+		void playback(Scene &scene);
+};
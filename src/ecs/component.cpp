@@ -1,9 +1,79 @@
 #include "component.hpp"
 
+#include "prefab.hpp"
 #include <type_traits>
 
-void ComponentManager::onEntityDestroyed(EntityId entity) {
-	for (const auto &[_, componentArray] : componentArrays) {
-		componentArray->onEntityDestroyed(entity);
+Signature &ComponentManager::getSignature(Entity entity) {
+	if (entity.id >= records.size()) records.resize(entity.id + 1);
+	auto &record = records[entity.id];
+	if (record.entity != entity) record = { .entity = entity, .signature = Signature() };
+	return record.signature;
+}
+
+void ComponentManager::setSignature(Entity entity, Signature signature) {
+	auto &current = getSignature(entity);
+	for (auto &[_, group] : groups) {
+		auto matched = group->matches(current);
+		auto matches = group->matches(signature);
+		if (!matched && matches) group->entities.insert(entity);
+		else if (matched && !matches) group->entities.remove(entity);
+	}
+	current = signature;
+}
+
+void ComponentManager::setSignatures(const std::vector<Entity> &entities, const std::vector<Signature> &signatures) {
+	std::vector<Signature *> current;
+	current.reserve(entities.size());
+	Signature changed;
+	for (size_t i = 0; i < entities.size(); i++) {
+		current.push_back(&getSignature(entities[i]));
+		changed |= *current[i] ^ signatures[i];
+	}
+
+	std::vector<Entity> removed;
+	for (auto &[_, group] : groups) {
+		if ((group->signature & changed).none()) continue;
+
+		removed.clear();
+		for (size_t i = 0; i < entities.size(); i++) {
+			auto matched = group->matches(*current[i]);
+			auto matches = group->matches(signatures[i]);
+			if (!matched && matches) group->entities.insert(entities[i]);
+			else if (matched && !matches) removed.push_back(entities[i]);
+		}
+		group->entities.removeAll(removed, [](size_t, size_t) {});
+	}
+	for (size_t i = 0; i < entities.size(); i++) *current[i] = signatures[i];
+}
+
+EntityGroup &ComponentManager::getGroup(Signature signature) {
+	auto it = groups.find(signature);
+	if (it != groups.end()) return *it->second;
+
+	auto group = std::make_unique<EntityGroup>(signature);
+	for (size_t id = 0; id < records.size(); id++) {
+		const auto &record = records[id];
+		if (record.signature.any() && group->matches(record.signature)) group->entities.insert(record.entity);
+	}
+	return *(groups[signature] = std::move(group));
+}
+
+void ComponentManager::instantiate(const Prefab &prefab, const std::vector<Entity> &entities) {
+	for (const auto &component : prefab.getComponents())
+		componentArrays[component->getType()]->insertCopies(component->getData(), entities, tick);
+	setSignatures(entities, std::vector<Signature>(entities.size(), prefab.getSignature()));
+}
+
+void ComponentManager::onEntitiesDestroyed(const std::vector<Entity> &entities) {
+	for (const auto &componentArray : componentArrays) {
+		if (componentArray) componentArray->onEntitiesDestroyed(entities);
+	}
+	setSignatures(entities, std::vector<Signature>(entities.size()));
+}
+
+void ComponentManager::onEntityDestroyed(Entity entity) {
+	for (const auto &componentArray : componentArrays) {
+		if (componentArray) componentArray->onEntityDestroyed(entity);
 	}
-}
\ No newline at end of file
+	setSignature(entity, Signature());
+}
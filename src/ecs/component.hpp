@@ -1,112 +1,238 @@
 #pragma once
 
+#include "../util/paged_vector.hpp"
+#include "sparse_set.hpp"
 #include "types.hpp"
-#include <array>
+#include "view.hpp"
 #include <cstddef>
-#include <iosfwd>
 #include <memory>
-#include <optional>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+class Prefab;
 
 class IComponentArray {
 	public:
 		virtual ~IComponentArray() = default;
-		virtual void onEntityDestroyed(EntityId entity) = 0;
+		virtual void insertCopies(const void *component, const std::vector<Entity> &entities, Tick tick) = 0;
+		virtual void onEntityDestroyed(Entity entity) = 0;
+		virtual void onEntitiesDestroyed(const std::vector<Entity> &entities) = 0;
 };
 
 template <typename T>
 class ComponentArray : public IComponentArray {
 	private:
-		std::array<std::shared_ptr<T>, MAX_ENTITIES> componentArray {};
-		std::unordered_map<EntityId, size_t> entityToIndexMap {};
-		std::unordered_map<size_t, EntityId> indexToEntityMap {};
-		size_t nComponents = 0;
+		using Storage = ComponentStorage<T>;
+
+		PagedVector<Storage> components {};
+		PagedVector<ComponentTicks> ticks {};
+		SparseSet entities {};
 
 	public:
-		void insertData(EntityId entity, std::shared_ptr<T> component) {
-			if (entityToIndexMap.count(entity) == 1)
-				throw std::runtime_error("Entity " + std::to_string(entity) + " already has a(n) `" + typeid(T).name() + "` component.");
+		void insertData(Entity entity, Storage component, Tick tick) {
+			if (entities.contains(entity))
+				throw std::runtime_error("Entity " + std::to_string(entity.id) + " already has a(n) `" + typeid(T).name() + "` component.");
+
+			entities.insert(entity);
+			components.push_back(std::move(component));
+			ticks.push_back({ .added = tick, .changed = tick });
+		};
+
+		void removeData(Entity entity) {
+			if (!entities.contains(entity))
+				throw std::runtime_error("Entity " + std::to_string(entity.id) + " does not have a(n) `" + typeid(T).name() + "` component.");
 
-			componentArray[nComponents] = component;
-			entityToIndexMap[entity] = nComponents;
-			indexToEntityMap[nComponents] = entity;
-			nComponents++;
+			auto index = entities.remove(entity);
+			components[index] = std::move(components.back());
+			components.pop_back();
+			ticks[index] = ticks.back();
+			ticks.pop_back();
 		};
 
-		void removeData(EntityId entity) {
-			if (entityToIndexMap.count(entity) != 1)
-				throw std::runtime_error("Entity " + std::to_string(entity) + " does not have a(n) `" + typeid(T).name() + "` component.");
+		void removeAll(const std::vector<Entity> &targets) {
+			entities.removeAll(targets, [this](size_t from, size_t to) {
+				components[to] = std::move(components[from]);
+				ticks[to] = ticks[from];
+			});
+			while (components.size() > entities.size()) {
+				components.pop_back();
+				ticks.pop_back();
+			}
+		};
 
-			auto index = entityToIndexMap[entity];
-			nComponents--;
+		void insertCopies(const void *component, const std::vector<Entity> &targets, Tick tick) override {
+			if constexpr (std::is_copy_constructible_v<Storage>) {
+				const auto &data = *static_cast<const Storage *>(component);
+				reserve(size() + targets.size());
+				for (auto entity : targets) insertData(entity, data, tick);
+			} else {
+				throw std::logic_error("`" + std::string(typeid(T).name()) + "` components cannot be copied.");
+			}
+		};
 
-			componentArray[index] = componentArray[nComponents];
-			auto lastEntity = indexToEntityMap[nComponents];
-			entityToIndexMap[lastEntity] = index;
-			indexToEntityMap[index] = lastEntity;
+		T *getData(Entity entity) {
+			auto index = entities.indexOf(entity);
+			if (index == SPARSE_INVALID_INDEX) return nullptr;
+			return componentPointer<T>(components[index]);
+		};
 
-			entityToIndexMap.erase(entity);
-			indexToEntityMap.erase(nComponents);
+		ComponentTicks *getTicks(Entity entity) {
+			auto index = entities.indexOf(entity);
+			if (index == SPARSE_INVALID_INDEX) return nullptr;
+			return &ticks[index];
 		};
 
-		OptionalComponent<T> getData(EntityId entity) {
-			auto it = entityToIndexMap.find(entity);
-			if (it == entityToIndexMap.end()) return std::nullopt;
-			return std::optional<std::shared_ptr<T>>(componentArray[it->second]);
+		size_t size() const { return components.size(); };
+		Entity getEntity(size_t index) const { return entities[index]; };
+		T &getDataAt(size_t index) { return *componentPointer<T>(components[index]); };
+
+		void reserve(size_t n) {
+			components.reserve(n);
+			ticks.reserve(n);
+			entities.reserve(n);
 		};
 
-		void onEntityDestroyed(EntityId entity) override {
-			removeData(entity);
+		void onEntityDestroyed(Entity entity) override {
+			if (entities.contains(entity)) removeData(entity);
 		};
+
+		void onEntitiesDestroyed(const std::vector<Entity> &destroyed) override { removeAll(destroyed); };
 };
 
 class ComponentManager {
 	private:
-		std::unordered_map<const char *, std::shared_ptr<IComponentArray>> componentArrays {};
+		std::vector<std::unique_ptr<IComponentArray>> componentArrays {};
+		struct EntityRecord {
+			Entity entity;
+			Signature signature;
+		};
+
+		PagedVector<EntityRecord> records {};
+		std::unordered_map<Signature, std::unique_ptr<EntityGroup>> groups {};
+		std::mutex groupMutex {};
+		Tick tick = 1;
+
+		Signature &getSignature(Entity entity);
+		void setSignature(Entity entity, Signature signature);
+		void setSignatures(const std::vector<Entity> &entities, const std::vector<Signature> &signatures);
+		EntityGroup &getGroup(Signature signature);
 
 		template <typename T>
-		std::shared_ptr<ComponentArray<T>> getComponentArray() {
-			auto name = typeid(T).name();
-			auto it = componentArrays.find(name);
-			if (it == componentArrays.end()) {
-				auto strName = std::string(name);
-				throw std::runtime_error("Component `" + strName + "` has not been registered.");
-			}
-			return std::static_pointer_cast<ComponentArray<T>>(it->second);
+		ComponentArray<T> *getComponentArray() {
+			auto type = componentType<T>();
+			if (type >= componentArrays.size()) return nullptr;
+			return static_cast<ComponentArray<T> *>(componentArrays[type].get());
 		};
 
 	public:
 		template <typename T>
-		void addComponent(EntityId entity, std::shared_ptr<T> component) {
-			std::shared_ptr<ComponentArray<T>> componentArray;
+		ComponentArray<T> &registerComponent() {
+			auto type = componentType<T>();
+			if (type >= MAX_COMPONENTS)
+				throw std::length_error("Component limit exceeded.");
+			if (type >= componentArrays.size()) componentArrays.resize(type + 1);
+			if (!componentArrays[type]) componentArrays[type] = std::make_unique<ComponentArray<T>>();
+			return *static_cast<ComponentArray<T> *>(componentArrays[type].get());
+		};
+
+		template <typename T>
+		void addComponent(Entity entity, ComponentStorage<T> component) {
+			registerComponent<T>().insertData(entity, std::move(component), tick);
+			setSignature(entity, Signature(getSignature(entity)).set(componentType<T>()));
+		};
+
+		template <typename T>
+		void addComponents(std::vector<std::pair<Entity, ComponentStorage<T>>> &components) {
+			auto &componentArray = registerComponent<T>();
+			componentArray.reserve(componentArray.size() + components.size());
+			std::vector<Entity> entities;
+			std::vector<Signature> signatures;
+			entities.reserve(components.size());
+			signatures.reserve(components.size());
 			try {
-				componentArray = getComponentArray<T>();
-			} catch (const std::runtime_error&) {
-				auto name = typeid(T).name();
-				componentArrays[name] = std::make_shared<ComponentArray<T>>();
-				componentArray = getComponentArray<T>();
+				for (auto &[entity, component] : components) {
+					componentArray.insertData(entity, std::move(component), tick);
+					entities.push_back(entity);
+					signatures.push_back(Signature(getSignature(entity)).set(componentType<T>()));
+				}
+			} catch (...) {
+				// Keep groups in step with the components inserted before the failure.
+				setSignatures(entities, signatures);
+				throw;
+			}
+			setSignatures(entities, signatures);
+		};
+
+		template <typename T>
+		void removeComponents(const std::vector<Entity> &entities) {
+			auto *componentArray = getComponentArray<T>();
+			if (!componentArray)
+				throw std::runtime_error("Component `" + std::string(typeid(T).name()) + "` has not been registered.");
+			for (auto entity : entities) {
+				if (!componentArray->getData(entity))
+					throw std::runtime_error("Entity " + std::to_string(entity.id) + " does not have a(n) `" + typeid(T).name() + "` component.");
 			}
 
-			componentArray->insertData(entity, component);
+			componentArray->removeAll(entities);
+			std::vector<Signature> signatures;
+			signatures.reserve(entities.size());
+			for (auto entity : entities) signatures.push_back(Signature(getSignature(entity)).reset(componentType<T>()));
+			setSignatures(entities, signatures);
 		};
 
 		template <typename T>
-		void removeComponent(EntityId entity) {
-			getComponentArray<T>()->removeData(entity);
+		void removeComponent(Entity entity) {
+			auto *componentArray = getComponentArray<T>();
+			if (!componentArray)
+				throw std::runtime_error("Component `" + std::string(typeid(T).name()) + "` has not been registered.");
+			componentArray->removeData(entity);
+			setSignature(entity, Signature(getSignature(entity)).reset(componentType<T>()));
 		};
 
 		template <typename T>
-		OptionalComponent<T> getComponent(EntityId entity) {
-			try {
-				return getComponentArray<T>()->getData(entity);
-			} catch (const std::runtime_error&) {
-				return std::nullopt;
-			}
+		T *getComponent(Entity entity) {
+			auto *componentArray = getComponentArray<T>();
+			if (!componentArray) return nullptr;
+			return componentArray->getData(entity);
 		};
 
-		void onEntityDestroyed(EntityId entity);
-};
\ No newline at end of file
+		template <typename T>
+		void markChanged(Entity entity) {
+			auto *componentArray = getComponentArray<T>();
+			auto *ticks = componentArray ? componentArray->getTicks(entity) : nullptr;
+			if (!ticks)
+				throw std::runtime_error("Entity " + std::to_string(entity.id) + " does not have a(n) `" + typeid(T).name() + "` component.");
+			ticks->changed = tick;
+		};
+
+		template <typename T, typename F>
+		void each(F &&fn) {
+			auto *componentArray = getComponentArray<T>();
+			if (!componentArray) return;
+
+			for (size_t i = 0; i < componentArray->size(); i++)
+				fn(componentArray->getEntity(i), componentArray->getDataAt(i));
+		};
+
+		template <typename... Ts>
+		View<Ts...> view() {
+			std::lock_guard lock(groupMutex);
+			auto &group = getGroup(signatureOf<Ts...>());
+			return View<Ts...>(group.entities, &registerComponent<Ts>()...);
+		};
+
+		// `entities` must not have any components yet.
+		void instantiate(const Prefab &prefab, const std::vector<Entity> &entities);
+
+		Tick getTick() const { return tick; };
+		Tick advanceTick() { return ++tick; };
+
+		void onEntityDestroyed(Entity entity);
+		void onEntitiesDestroyed(const std::vector<Entity> &entities);
+};
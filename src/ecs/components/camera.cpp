@@ -5,9 +5,9 @@
 #include <algorithm>
 #include <cmath>
 
-void Camera::updateCameraVectors(std::shared_ptr<Transform> transform) {
-	auto yaw = transform->rotation.y;
-	auto pitch = transform->rotation.x;
+void Camera::updateCameraVectors(const Transform &transform) {
+	auto yaw = transform.getRotation().y;
+	auto pitch = transform.getRotation().x;
 	front = glm::normalize(
 		glm::vec3(
 			cos(glm::radians(yaw)) * cos(glm::radians(pitch)),
@@ -19,35 +19,39 @@ void Camera::updateCameraVectors(std::shared_ptr<Transform> transform) {
 	up = glm::normalize(glm::cross(right, front));
 }
 
-void Camera::move(std::shared_ptr<Transform> transform, CameraDirection dir, float delta) {
+void Camera::move(Transform &transform, CameraDirection dir, float delta) {
+	auto position = transform.getPosition();
 	switch (dir) {
 		case FORWARD:
-			transform->position += front * speed * delta;
+			position += front * speed * delta;
 			break;
 		case BACKWARD:
-			transform->position -= front * speed * delta;
+			position -= front * speed * delta;
 			break;
 		case LEFT:
-			transform->position -= right * speed * delta;
+			position -= right * speed * delta;
 			break;
 		case RIGHT:
-			transform->position += right * speed * delta;
+			position += right * speed * delta;
 			break;
 		case UP:
-			transform->position += up * speed * delta;
+			position += up * speed * delta;
 			break;
 		case DOWN:
-			transform->position -= up * speed * delta;
+			position -= up * speed * delta;
 			break;
 	}
+	transform.setPosition(position);
 }
 
-void Camera::processCursor(std::shared_ptr<Transform> transform, float xOffset, float yOffset, float delta, bool constrainPitch) {
-	transform->rotation.y += xOffset * sensitivity * delta;
-	transform->rotation.x += yOffset * sensitivity * delta;
+void Camera::processCursor(Transform &transform, float xOffset, float yOffset, float delta, bool constrainPitch) {
+	auto rotation = transform.getRotation();
+	rotation.y += xOffset * sensitivity * delta;
+	rotation.x += yOffset * sensitivity * delta;
 
 	if (constrainPitch)
-		transform->rotation.x = std::clamp(transform->rotation.x, -89.0f, 89.0f);
+		rotation.x = std::clamp(rotation.x, -89.0f, 89.0f);
 
+	transform.setRotation(rotation);
 	updateCameraVectors(transform);
 }
\ No newline at end of file
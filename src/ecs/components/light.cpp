@@ -1,51 +1,56 @@
 #include "light.hpp"
 
-#include "../../graphics/shader.hpp"
+#include "../../graphics/uniforms.hpp"
 #include "transform.hpp"
-#include <iosfwd>
-#include <string>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
-void Light::use(std::shared_ptr<ShaderProgram> shader, std::shared_ptr<Transform> transform, glm::mat4 view, int n) {
-	std::string prefix;
-	switch (type) {
-		case DIRECTIONAL:
-			prefix = "directionalLights[";
-			break;
-		case POINT:
-			prefix = "pointLights[";
-			break;
-		case SPOT:
-			prefix = "spotLights[";
-			break;
-	}
-	prefix += std::to_string(n) + "].";
+float Light::getRange() const {
+	// Solves max(color) / (1 + linear * d + quadratic * d^2) = 1 / 256 for d.
+	float brightest = std::max({ ambient.r, ambient.g, ambient.b, diffuse.r, diffuse.g, diffuse.b, specular.r, specular.g, specular.b });
+	float constant = 1.0f - 256.0f * brightest;
+	if (constant >= 0.0f) return 0.0f;
+	if (quadratic > 0.0f) return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * constant)) / (2.0f * quadratic);
+	if (linear > 0.0f) return -constant / linear;
+	return std::numeric_limits<float>::max();
+}
 
-	shader->tryUniformVec3(prefix + "properties.ambient", ambient);
-	shader->tryUniformVec3(prefix + "properties.diffuse", diffuse);
-	shader->tryUniformVec3(prefix + "properties.specular", specular);
+void Light::store(LightUniforms &uniforms, std::vector<LocalLightTexels> &localLights, const Transform &transform, const glm::mat4 &world, const glm::mat4 &view) const {
+	// Only the parents' part of the world matrix turns the direction.
+	auto direction = glm::mat3(world) * glm::inverse(glm::mat3(transform.getMatrix())) * transform.getRotation();
 
-	if (type != DIRECTIONAL) {
-		shader->tryUniformFloat(prefix + "attenuation.linear", linear);
-		shader->tryUniformFloat(prefix + "attenuation.quadratic", quadratic);
-		shader->tryUniformVec3(
-			prefix + "position",
-			glm::vec3(
-				view * glm::vec4(
-					transform->position.x,
-					transform->position.y,
-					transform->position.z,
-					1.0f
-				)
-			)
-		);
+	if (type == DIRECTIONAL) {
+		if (uniforms.nDirectionalLights >= MAX_DIRECTIONAL_LIGHTS) return;
+		auto &light = uniforms.directionalLights[uniforms.nDirectionalLights++];
+		light = {};
+		light.direction = direction;
+		light.properties.ambient = ambient;
+		light.properties.diffuse = diffuse;
+		light.properties.specular = specular;
+		return;
 	}
 
-	if (type != POINT) {
-		shader->tryUniformVec3(prefix + "direction", transform->rotation);
-	}
+	float range = getRange();
+	if (range <= 0.0f) return;
 
+	LocalLightTexels light {};
+	light.position = glm::vec3(view * world[3]);
+	light.range = range;
+	light.ambient = ambient;
+	light.diffuse = diffuse;
+	light.specular = specular;
+	light.linear = linear;
+	light.quadratic = quadratic;
 	if (type == SPOT) {
-		shader->tryUniformFloat(prefix + "phi", phi);
-		shader->tryUniformFloat(prefix + "gamma", gamma);
+		light.direction = direction;
+		light.phi = phi;
+		light.gamma = gamma;
+	} else {
+		light.direction = glm::vec3(0.0f, 0.0f, -1.0f);
+		light.phi = -1.0f;
+		light.gamma = -2.0f;
 	}
+	localLights.push_back(light);
 }
\ No newline at end of file
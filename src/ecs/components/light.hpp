@@ -2,10 +2,11 @@
 
 #include <glm/glm.hpp>
 #include <cmath>
-#include <memory>
+#include <vector>
 
-class ShaderProgram;
-struct Transform;
+class Transform;
+struct LightUniforms;
+struct LocalLightTexels;
 
 enum LightType {
 	DIRECTIONAL,
@@ -27,5 +28,8 @@ struct Light {
 	float gamma = cos(glm::radians(15.0f));
 
 	Light(LightType type) : type(type) {};
-	void use(std::shared_ptr<ShaderProgram> shader, std::shared_ptr<Transform> transform, glm::mat4 view, int n);
+	// Distance past which the light adds less than 1/256 to any channel.
+	float getRange() const;
+	// `world` differs from `transform.getMatrix()` under a Parent.
+	void store(LightUniforms &uniforms, std::vector<LocalLightTexels> &localLights, const Transform &transform, const glm::mat4 &world, const glm::mat4 &view) const;
 };
\ No newline at end of file
@@ -0,0 +1,4 @@
+#pragma once
+
+// Rasterized on the CPU every frame, so occluders should be large and simple.
+struct Occluder {};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "../types.hpp"
+
+struct Parent {
+	Entity entity;
+};
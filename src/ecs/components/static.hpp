@@ -0,0 +1,4 @@
+#pragma once
+
+// Culled and queried through the scene BVH instead of every frame.
+struct Static {};
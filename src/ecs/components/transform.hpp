@@ -1,15 +1,58 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
-struct Transform {
-	glm::vec3 position;
-	glm::vec3 rotation;
-	glm::vec3 scale;
-
-	Transform(
-		const glm::vec3 &position = glm::vec3(0.0f),
-		const glm::vec3 &rotation = glm::vec3(0.0f),
-		const glm::vec3 &scale = glm::vec3(1.0f)
-	) : position(position), rotation(rotation), scale(scale) {};
-};
\ No newline at end of file
+// Rotation is Euler degrees applied X, Y, then Z; the setters keep the matrix up to date.
+class Transform {
+	private:
+		glm::vec3 position;
+		glm::vec3 rotation;
+		glm::vec3 scale;
+		glm::quat orientation;
+		glm::mat4 matrix;
+
+		void updateBasis() {
+			auto rotationMatrix = glm::mat3_cast(orientation);
+			matrix[0] = glm::vec4(rotationMatrix[0] * scale.x, 0.0f);
+			matrix[1] = glm::vec4(rotationMatrix[1] * scale.y, 0.0f);
+			matrix[2] = glm::vec4(rotationMatrix[2] * scale.z, 0.0f);
+		};
+
+	public:
+		Transform(
+			const glm::vec3 &position = glm::vec3(0.0f),
+			const glm::vec3 &rotation = glm::vec3(0.0f),
+			const glm::vec3 &scale = glm::vec3(1.0f)
+		) : position(position), scale(scale), matrix(1.0f) {
+			matrix[3] = glm::vec4(position, 1.0f);
+			setRotation(rotation);
+		};
+
+		const glm::vec3 &getPosition() const { return position; };
+		const glm::vec3 &getRotation() const { return rotation; };
+		const glm::vec3 &getScale() const { return scale; };
+		const glm::quat &getOrientation() const { return orientation; };
+		const glm::mat4 &getMatrix() const { return matrix; };
+		bool hasUniformScale() const { return scale.x == scale.y && scale.y == scale.z; };
+
+		void setPosition(const glm::vec3 &position) {
+			this->position = position;
+			matrix[3] = glm::vec4(position, 1.0f);
+		};
+
+		void setRotation(const glm::vec3 &rotation) {
+			this->rotation = rotation;
+			auto radians = glm::radians(rotation);
+			orientation =
+				glm::angleAxis(radians.x, glm::vec3(1.0f, 0.0f, 0.0f)) *
+				glm::angleAxis(radians.y, glm::vec3(0.0f, 1.0f, 0.0f)) *
+				glm::angleAxis(radians.z, glm::vec3(0.0f, 0.0f, 1.0f));
+			updateBasis();
+		};
+
+		void setScale(const glm::vec3 &scale) {
+			this->scale = scale;
+			updateBasis();
+		};
+};
@@ -2,15 +2,34 @@
 
 #include <stdexcept>
 
-std::shared_ptr<Entity> EntityManager::createEntity() {
-	if (nEntities >= MAX_ENTITIES) throw std::length_error("Entity limit exceeded.");
-	auto entity = std::make_shared<Entity>(scene, availableEntityIds.front());
-	availableEntityIds.pop();
-	nEntities++;
-	return entity;
+Entity EntityManager::createEntity() {
+	if (!availableEntityIds.empty()) {
+		auto id = availableEntityIds.back();
+		availableEntityIds.pop_back();
+		return { .id = id, .generation = generations[id] };
+	}
+
+	if (generations.size() == INVALID_ENTITY) throw std::length_error("Entity limit exceeded.");
+	EntityId id = generations.size();
+	generations.push_back(0);
+	return { .id = id, .generation = 0 };
+}
+
+void EntityManager::destroyEntity(Entity entity) {
+	generations[entity.id]++;
+	availableEntityIds.push_back(entity.id);
 }
 
-void EntityManager::destroyEntity(EntityId entity) {
-	availableEntityIds.push(entity);
-	nEntities--;
-}
\ No newline at end of file
+void ActiveEntities::insert(Entity entity) {
+	if (entity.id >= positions.size()) positions.resize(entity.id + 1);
+	positions[entity.id] = entities.size();
+	entities.push_back(entity);
+}
+
+void ActiveEntities::erase(Entity entity) {
+	auto position = positions[entity.id];
+	auto last = entities.back();
+	entities[position] = last;
+	positions[last.id] = position;
+	entities.pop_back();
+}
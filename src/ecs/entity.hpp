@@ -1,53 +1,58 @@
 #pragma once
 
-#include "scene.hpp"
+#include "../util/paged_vector.hpp"
 #include "types.hpp"
-#include <memory>
-#include <queue>
+#include <cstddef>
+#include <iterator>
+#include <vector>
 
-class Entity {
+class EntityManager {
 	private:
-		Scene &scene;
-		EntityId id;
+		PagedVector<EntityGeneration> generations {};
+		std::vector<EntityId> availableEntityIds {};
 
 	public:
-		Entity(Scene &scene, EntityId id) : scene(scene), id(id) {};
-		EntityId getId() { return id; };
-		void destroy() { scene.destroyEntity(id); };
-
-		template <typename T>
-		void addComponent(T component) {
-			scene.addComponent(id, std::make_shared<T>(component));
-		};
-
-		template <typename T>
-		void addComponent(std::shared_ptr<T> component) {
-			scene.addComponent(id, component);
-		};
-
-		template <typename T>
-		void removeComponent() {
-			scene.removeComponent<T>(id);
-		};
-
-		template <typename T>
-		OptionalComponent<T> getComponent() {
-			return scene.getComponent<T>(id);
+		Entity createEntity();
+		void destroyEntity(Entity entity);
+		bool isAlive(Entity entity) const {
+			return entity.id < generations.size() && generations[entity.id] == entity.generation;
 		};
 };
 
-class EntityManager {
+class ActiveEntities {
 	private:
-	 	Scene &scene;
-		std::queue<EntityId> availableEntityIds {};
-		unsigned int nEntities = 0;
+		PagedVector<Entity> entities {};
+		PagedVector<size_t> positions {};
 
 	public:
-		EntityManager(Scene &scene) : scene(scene) {
-			for (EntityId e = 0; e < MAX_ENTITIES; e++)
-				availableEntityIds.push(e);
+		struct Iterator {
+			using value_type = Entity;
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category	= std::forward_iterator_tag;
+
+			const ActiveEntities *activeEntities;
+			size_t index;
+
+			Iterator(const ActiveEntities *activeEntities, size_t index) : activeEntities(activeEntities), index(index) {};
+
+			reference operator*() const { return (*activeEntities)[index]; };
+
+			Iterator& operator++() { index++; return *this; };
+			Iterator operator++(int) { Iterator i(*this); ++(*this); return i; };
+
+			bool operator==(const Iterator &rhs) const { return index == rhs.index; };
+			bool operator!=(const Iterator &rhs) const { return index != rhs.index; };
 		};
 
-		std::shared_ptr<Entity> createEntity();
-		void destroyEntity(EntityId entityId);
-};
\ No newline at end of file
+		void insert(Entity entity);
+		void erase(Entity entity);
+		void reserve(size_t n) { entities.reserve(n); };
+
+		size_t size() const { return entities.size(); };
+		Entity operator[](size_t index) const { return entities[index]; };
+
+		Iterator begin() const { return Iterator(this, 0); };
+		Iterator end() const { return Iterator(this, entities.size()); };
+};
@@ -0,0 +1,201 @@
+#include "hierarchy.hpp"
+
+#include "../util/thread_pool.hpp"
+#include "../util/transform_batch.hpp"
+#include "components/parent.hpp"
+#include "components/transform.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+size_t TransformHierarchy::indexOf(Entity entity) const {
+	if (entity.id >= indices.size()) return HIERARCHY_INVALID_INDEX;
+	auto index = indices[entity.id];
+	if (index == HIERARCHY_INVALID_INDEX || nodes[index].entity != entity) return HIERARCHY_INVALID_INDEX;
+	return index;
+}
+
+bool TransformHierarchy::needsRebuild(Scene &scene, Tick since) {
+	auto transforms = scene.view<Transform>();
+	auto parents = scene.view<Parent>();
+	if (transforms.size() != nTransforms || parents.size() != nParents) return true;
+
+	bool changed = false;
+	transforms.each(Added<Transform>(since), [&](Entity, Transform &) { changed = true; });
+	parents.each(Changed<Parent>(since), [&](Entity, Parent &) { changed = true; });
+	return changed;
+}
+
+void TransformHierarchy::rebuild(Scene &scene) {
+	// Left zeroed if this throws, so the next update retries.
+	nTransforms = 0;
+	nParents = 0;
+
+	std::vector<Entity> entities;
+	std::vector<size_t> order;
+	scene.view<Transform>().each([&](Entity entity, Transform &) {
+		if (entity.id >= order.size()) order.resize(entity.id + 1, HIERARCHY_INVALID_INDEX);
+		order[entity.id] = entities.size();
+		entities.push_back(entity);
+	});
+
+	auto find = [&](Entity entity) {
+		if (entity.id >= order.size() || order[entity.id] == HIERARCHY_INVALID_INDEX) return HIERARCHY_INVALID_INDEX;
+		auto index = order[entity.id];
+		return entities[index] == entity ? index : HIERARCHY_INVALID_INDEX;
+	};
+
+	std::vector<size_t> parentOf(entities.size(), HIERARCHY_INVALID_INDEX);
+	std::vector<size_t> childStart(entities.size() + 1, 0);
+	for (size_t i = 0; i < entities.size(); i++) {
+		auto *parent = scene.getComponent<Parent>(entities[i]);
+		if (parent) parentOf[i] = find(parent->entity);
+		if (parentOf[i] != HIERARCHY_INVALID_INDEX) childStart[parentOf[i] + 1]++;
+	}
+	for (size_t i = 0; i < entities.size(); i++) childStart[i + 1] += childStart[i];
+
+	std::vector<size_t> children(childStart.back());
+	std::vector<size_t> filled(childStart.begin(), childStart.end() - 1);
+	for (size_t i = 0; i < entities.size(); i++) {
+		if (parentOf[i] != HIERARCHY_INVALID_INDEX) children[filled[parentOf[i]]++] = i;
+	}
+
+	nodes.clear();
+	roots.clear();
+	rootOf.clear();
+	indices.assign(order.size(), HIERARCHY_INVALID_INDEX);
+	for (size_t root = 0; root < entities.size(); root++) {
+		if (parentOf[root] != HIERARCHY_INVALID_INDEX) continue;
+
+		// Breadth-first, so every subtree is sorted by depth.
+		Range range { .begin = nodes.size(), .end = nodes.size() };
+		indices[entities[root].id] = nodes.size();
+		nodes.push_back({ .entity = entities[root], .parent = HIERARCHY_INVALID_INDEX });
+		for (size_t node = range.begin; node < nodes.size(); node++) {
+			auto current = order[nodes[node].entity.id];
+			for (auto child = childStart[current]; child < childStart[current + 1]; child++) {
+				indices[entities[children[child]].id] = nodes.size();
+				nodes.push_back({ .entity = entities[children[child]], .parent = node });
+			}
+		}
+		range.end = nodes.size();
+
+		rootOf.resize(nodes.size(), roots.size());
+		roots.push_back(range);
+	}
+
+	if (nodes.size() != entities.size())
+		throw std::runtime_error("Transform hierarchy contains a cycle.");
+
+	worldMatrices.resize(nodes.size());
+	normalMatrices.resize(nodes.size());
+	worldScales.resize(nodes.size());
+	dirty.assign(nodes.size(), 1);
+
+	nTransforms = entities.size();
+	nParents = scene.view<Parent>().size();
+}
+
+void TransformHierarchy::computeRoots(Scene &scene, const Range *first, const Range *last) {
+	std::vector<size_t> indices;
+	TransformBatch batch;
+	for (auto range = first; range != last; range++) {
+		if (!dirty[range->begin]) continue;
+		const auto &transform = *scene.getComponent<Transform>(nodes[range->begin].entity);
+		indices.push_back(range->begin);
+		batch.push(transform.getPosition(), transform.getOrientation(), transform.getScale());
+		worldScales[range->begin] = transform.hasUniformScale() ? transform.getScale().x : 0.0f;
+	}
+	if (indices.empty()) return;
+
+	std::vector<glm::mat4> models(indices.size());
+	std::vector<glm::mat3> normals(indices.size());
+	computeModelMatrices(batch.getArrays(), models.data(), normals.data());
+	for (size_t i = 0; i < indices.size(); i++) {
+		worldMatrices[indices[i]] = models[i];
+		normalMatrices[indices[i]] = normals[i];
+	}
+}
+
+void TransformHierarchy::propagate(Scene &scene, Range range) {
+	for (auto i = range.begin + 1; i < range.end; i++) {
+		const auto &node = nodes[i];
+		if (dirty[node.parent]) dirty[i] = 1;
+		if (!dirty[i]) continue;
+
+		const auto &transform = *scene.getComponent<Transform>(node.entity);
+		worldMatrices[i] = worldMatrices[node.parent] * transform.getMatrix();
+		auto parentScale = worldScales[node.parent];
+
+		if (parentScale > 0.0f) {
+			// Under rotation and uniform scale, the inverse transpose divides by the squared scale.
+			auto scale = transform.getScale() * parentScale;
+			glm::mat3 basis(worldMatrices[i]);
+			normalMatrices[i] = glm::mat3(basis[0] / (scale.x * scale.x), basis[1] / (scale.y * scale.y), basis[2] / (scale.z * scale.z));
+			worldScales[i] = transform.hasUniformScale() ? scale.x : 0.0f;
+		} else {
+			normalMatrices[i] = glm::mat3(glm::transpose(glm::inverse(worldMatrices[i])));
+			worldScales[i] = 0.0f;
+		}
+	}
+	std::fill(dirty.begin() + range.begin, dirty.begin() + range.end, 0);
+}
+
+void TransformHierarchy::update(Scene &scene, Tick since) {
+	if (needsRebuild(scene, since)) {
+		rebuild(scene);
+	} else {
+		scene.view<Transform>().each(Changed<Transform>(since), [&](Entity entity, Transform &) {
+			auto index = indexOf(entity);
+			if (index != HIERARCHY_INVALID_INDEX) dirty[index] = 1;
+		});
+	}
+
+	std::vector<Range> dirtyRoots;
+	size_t nDirty = 0;
+	for (size_t i = 0; i < nodes.size(); i++) {
+		if (!dirty[i]) continue;
+		const auto &root = roots[rootOf[i]];
+		if (dirtyRoots.empty() || dirtyRoots.back().begin != root.begin) {
+			dirtyRoots.push_back(root);
+			nDirty += root.end - root.begin;
+		}
+		i = root.end - 1;
+	}
+
+	if (nDirty < HIERARCHY_PARALLEL_THRESHOLD || !pool || pool->size() < 2) {
+		computeRoots(scene, dirtyRoots.data(), dirtyRoots.data() + dirtyRoots.size());
+		for (auto range : dirtyRoots) propagate(scene, range);
+		return;
+	}
+
+	auto batchSize = std::max(nDirty / (pool->size() * 4), HIERARCHY_PARALLEL_THRESHOLD / 4);
+	std::vector<size_t> batches { 0 };
+	for (size_t last = 0; last < dirtyRoots.size();) {
+		size_t n = 0;
+		while (last < dirtyRoots.size() && n < batchSize) {
+			n += dirtyRoots[last].end - dirtyRoots[last].begin;
+			last++;
+		}
+		batches.push_back(last);
+	}
+
+	pool->parallelFor(batches.size() - 1, [&](size_t batch) {
+		computeRoots(scene, dirtyRoots.data() + batches[batch], dirtyRoots.data() + batches[batch + 1]);
+		for (auto i = batches[batch]; i < batches[batch + 1]; i++) propagate(scene, dirtyRoots[i]);
+	});
+}
+
+const glm::mat4 &TransformHierarchy::getWorldMatrix(Entity entity) const {
+	auto index = indexOf(entity);
+	if (index == HIERARCHY_INVALID_INDEX)
+		throw std::invalid_argument("Entity " + std::to_string(entity.id) + " is not in the transform hierarchy.");
+	return worldMatrices[index];
+}
+
+const glm::mat3 &TransformHierarchy::getNormalMatrix(Entity entity) const {
+	auto index = indexOf(entity);
+	if (index == HIERARCHY_INVALID_INDEX)
+		throw std::invalid_argument("Entity " + std::to_string(entity.id) + " is not in the transform hierarchy.");
+	return normalMatrices[index];
+}
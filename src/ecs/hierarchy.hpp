@@ -0,0 +1,55 @@
+#pragma once
+
+#include "scene.hpp"
+#include "types.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+class ThreadPool;
+
+const size_t HIERARCHY_INVALID_INDEX = std::numeric_limits<size_t>::max();
+const size_t HIERARCHY_PARALLEL_THRESHOLD = 4096;
+
+// Each root's subtree is contiguous and sorted by depth, so one forward pass propagates it.
+class TransformHierarchy {
+	private:
+		struct Node {
+			Entity entity;
+			size_t parent;
+		};
+
+		struct Range {
+			size_t begin;
+			size_t end;
+		};
+
+		std::vector<Node> nodes {};
+		std::vector<glm::mat4> worldMatrices {};
+		std::vector<glm::mat3> normalMatrices {};
+		// 0 unless the matrix is only rotation and uniform scale.
+		std::vector<float> worldScales {};
+		std::vector<unsigned char> dirty {};
+		std::vector<Range> roots {};
+		std::vector<size_t> rootOf {};
+		std::vector<size_t> indices {};
+		size_t nTransforms = 0;
+		size_t nParents = 0;
+		ThreadPool *pool;
+
+		bool needsRebuild(Scene &scene, Tick since);
+		void rebuild(Scene &scene);
+		void computeRoots(Scene &scene, const Range *first, const Range *last);
+		void propagate(Scene &scene, Range range);
+		size_t indexOf(Entity entity) const;
+
+	public:
+		TransformHierarchy(ThreadPool *pool = nullptr) : pool(pool) {};
+
+		void update(Scene &scene, Tick since);
+
+		bool contains(Entity entity) const { return indexOf(entity) != HIERARCHY_INVALID_INDEX; };
+		const glm::mat4 &getWorldMatrix(Entity entity) const;
+		const glm::mat3 &getNormalMatrix(Entity entity) const;
+};
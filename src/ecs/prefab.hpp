@@ -0,0 +1,70 @@
+#pragma once
+
+#include "scene.hpp"
+#include "types.hpp"
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+class IPrefabComponent {
+	public:
+		virtual ~IPrefabComponent() = default;
+		virtual ComponentType getType() const = 0;
+		virtual void registerWith(Scene &scene) const = 0;
+		virtual const void *getData() const = 0;
+		virtual void copyTo(void *dst) const = 0;
+};
+
+template <typename T>
+class PrefabComponent : public IPrefabComponent {
+	private:
+		ComponentStorage<T> component;
+
+	public:
+		PrefabComponent(ComponentStorage<T> component) : component(std::move(component)) {};
+
+		ComponentType getType() const override { return componentType<T>(); };
+		void registerWith(Scene &scene) const override { scene.registerComponent<T>(); };
+		const void *getData() const override { return &component; };
+		void copyTo(void *dst) const override { new (dst) ComponentStorage<T>(component); };
+};
+
+// Copied onto new entities in bulk, so shared assets are never re-created per entity.
+class Prefab {
+	private:
+		std::vector<std::unique_ptr<IPrefabComponent>> components {};
+		Signature signature;
+
+		template <typename T>
+		Prefab &set(ComponentStorage<T> component) {
+			auto type = componentType<T>();
+			auto entry = std::make_unique<PrefabComponent<T>>(std::move(component));
+			for (auto &existing : components) {
+				if (existing->getType() == type) {
+					existing = std::move(entry);
+					return *this;
+				}
+			}
+
+			components.push_back(std::move(entry));
+			signature.set(type);
+			return *this;
+		};
+
+	public:
+		template <typename T>
+		Prefab &with(T component) {
+			static_assert(!SharedComponent<T>::value, "Shared components must be added by pointer.");
+			return set<T>(std::move(component));
+		};
+
+		template <typename T>
+		Prefab &with(std::shared_ptr<T> component) {
+			static_assert(SharedComponent<T>::value, "Only shared components can be added by pointer.");
+			return set<T>(std::move(component));
+		};
+
+		Signature getSignature() const { return signature; };
+		const std::vector<std::unique_ptr<IPrefabComponent>> &getComponents() const { return components; };
+};
@@ -1,16 +1,48 @@
 #include "scene.hpp"
 
-#include "entity.hpp"
+#include "prefab.hpp"
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
-std::shared_ptr<Entity> Scene::createEntity() {
+Entity Scene::createEntity() {
 	auto entity = entityManager->createEntity();
-	activeEntities->map.insert({entity->getId(), entity});
+	activeEntities->insert(entity);
 	return entity;
 }
 
-void Scene::destroyEntity(EntityId entity) {
-	entityManager->destroyEntity(entity);
+std::vector<Entity> Scene::createEntities(size_t n) {
+	std::vector<Entity> entities;
+	entities.reserve(n);
+	activeEntities->reserve(activeEntities->size() + n);
+	for (size_t i = 0; i < n; i++) entities.push_back(createEntity());
+	return entities;
+}
+
+std::vector<Entity> Scene::instantiate(const Prefab &prefab, size_t count) {
+	for (const auto &component : prefab.getComponents()) component->registerWith(*this);
+	auto entities = createEntities(count);
+	componentManager->instantiate(prefab, entities);
+	return entities;
+}
+
+void Scene::destroyEntities(const std::vector<Entity> &entities) {
+	for (auto entity : entities) checkAlive(entity);
+	// A repeated entity would be freed twice, handing its id to two later entities.
+	auto unique = entities;
+	std::sort(unique.begin(), unique.end(), [](Entity a, Entity b) { return a.id < b.id; });
+	unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+	componentManager->onEntitiesDestroyed(unique);
+	for (auto entity : unique) {
+		activeEntities->erase(entity);
+		entityManager->destroyEntity(entity);
+	}
+}
+
+void Scene::destroyEntity(Entity entity) {
+	checkAlive(entity);
 	componentManager->onEntityDestroyed(entity);
-	activeEntities->map.erase(entity);
-}
\ No newline at end of file
+	activeEntities->erase(entity);
+	entityManager->destroyEntity(entity);
+}
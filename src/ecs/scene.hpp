@@ -1,78 +1,105 @@
 #pragma once
 
-#include "component.hpp"
+#include "entity.hpp"
 #include "types.hpp"
-#include <cstddef>
-#include <iterator>
-#include <map>
+#ifdef ECS_ARCHETYPE_STORAGE
+#include "archetype.hpp"
+#else
+#include "component.hpp"
+#include "view.hpp"
+#endif
 #include <memory>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
-class Entity;
-class EntityManager;
-
-class ActiveEntities {
-	private:
-		using Value = std::shared_ptr<Entity>;
-		using ActiveEntityMap = std::map<EntityId, std::shared_ptr<Entity>>;
-
-	public:
-		ActiveEntityMap map;
-
-		struct Iterator {
-			using value_type = Value;
-			using reference = value_type&;
-			using pointer = value_type*;
-			using difference_type = std::ptrdiff_t;
-			using iterator_category	= std::forward_iterator_tag;
-
-			ActiveEntityMap::iterator iter;
+class Prefab;
 
-			Iterator(ActiveEntityMap::iterator iter) : iter(iter) {};
-
-			reference operator*() const { return iter->second; };
-			reference operator->() const { return iter->second; };
-
-			Iterator& operator++() { iter++; return *this; };
-			Iterator operator++(int) { Iterator i(*this); ++(*this); return i; };
-
-			bool operator==(const Iterator &rhs) const { return iter == rhs.iter; };
-			bool operator!=(const Iterator &rhs) const { return iter != rhs.iter; };
-		};
-
-		Iterator begin() { return Iterator(map.begin()); };
-		Iterator end() { return Iterator(map.end()); };
-};
+#ifdef ECS_ARCHETYPE_STORAGE
+using SceneStorage = ArchetypeManager;
+#else
+using SceneStorage = ComponentManager;
+#endif
 
 class Scene {
 	private:
-		std::unique_ptr<EntityManager> entityManager = std::make_unique<EntityManager>(*this);
-		std::unique_ptr<ComponentManager> componentManager = std::make_unique<ComponentManager>();
+		std::unique_ptr<EntityManager> entityManager = std::make_unique<EntityManager>();
+		std::unique_ptr<SceneStorage> componentManager = std::make_unique<SceneStorage>();
 		std::unique_ptr<ActiveEntities> activeEntities = std::make_unique<ActiveEntities>();
 
+		void checkAlive(Entity entity) const {
+			if (!entityManager->isAlive(entity)) throw std::invalid_argument("Entity " + std::to_string(entity.id) + " handle is stale.");
+		};
+
 	public:
-		std::shared_ptr<Entity> createEntity();
-		void destroyEntity(EntityId entity);
+		Entity createEntity();
+		std::vector<Entity> createEntities(size_t n);
+		std::vector<Entity> instantiate(const Prefab &prefab, size_t count = 1);
+		void destroyEntity(Entity entity);
+		void destroyEntities(const std::vector<Entity> &entities);
+		bool isAlive(Entity entity) const { return entityManager->isAlive(entity); };
+
+		template <typename T>
+		void registerComponent() {
+			componentManager->registerComponent<T>();
+		};
+
+		template <typename T>
+		void addComponent(Entity entity, T component) {
+			static_assert(!SharedComponent<T>::value, "Shared components must be added by pointer.");
+			checkAlive(entity);
+			componentManager->addComponent<T>(entity, std::move(component));
+		};
 
 		template <typename T>
-		void addComponent(EntityId entity, T component) {
-			componentManager->addComponent(entity, std::make_shared<T>(component));
+		void addComponent(Entity entity, std::shared_ptr<T> component) {
+			static_assert(SharedComponent<T>::value, "Only shared components can be added by pointer.");
+			checkAlive(entity);
+			componentManager->addComponent<T>(entity, std::move(component));
 		};
 
 		template <typename T>
-		void addComponent(EntityId entity, std::shared_ptr<T> component) {
-			componentManager->addComponent(entity, component);
+		void addComponents(std::vector<std::pair<Entity, ComponentStorage<T>>> &components) {
+			for (const auto &[entity, _] : components) checkAlive(entity);
+			componentManager->addComponents<T>(components);
 		};
 
 		template <typename T>
-		void removeComponent(EntityId entity) {
+		void removeComponent(Entity entity) {
+			checkAlive(entity);
 			componentManager->removeComponent<T>(entity);
 		};
 
 		template <typename T>
-		OptionalComponent<T> getComponent(EntityId entity) {
+		void removeComponents(const std::vector<Entity> &entities) {
+			for (auto entity : entities) checkAlive(entity);
+			componentManager->removeComponents<T>(entities);
+		};
+
+		template <typename T>
+		T *getComponent(Entity entity) {
 			return componentManager->getComponent<T>(entity);
 		};
 
-		ActiveEntities &getActiveEntities() { return *activeEntities; };
+		// Call after modifying a component through a reference so `Changed<T>` finds it.
+		template <typename T>
+		void markChanged(Entity entity) {
+			componentManager->markChanged<T>(entity);
+		};
+
+		template <typename T, typename F>
+		void each(F &&fn) {
+			componentManager->each<T>(std::forward<F>(fn));
+		};
+
+		template <typename... Ts>
+		auto view() {
+			return componentManager->view<Ts...>();
+		};
+
+		const ActiveEntities &getActiveEntities() const { return *activeEntities; };
+
+		Tick getTick() const { return componentManager->getTick(); };
+		Tick advanceTick() { return componentManager->advanceTick(); };
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "scene_bvh.hpp"
+
+#include "../graphics/model.hpp"
+#include "components/static.hpp"
+#include "components/transform.hpp"
+#include "hierarchy.hpp"
+#include <utility>
+
+uint32_t SceneBVH::indexOf(Entity entity) const {
+	if (entity.id >= indices.size()) return BVH_INVALID_INDEX;
+	auto index = indices[entity.id];
+	if (index == BVH_INVALID_INDEX || entities[index] != entity) return BVH_INVALID_INDEX;
+	return index;
+}
+
+bool SceneBVH::needsRebuild(Scene &scene, Tick since) {
+	auto view = scene.view<Static, Transform, Model>();
+	if (view.size() != entities.size()) return true;
+
+	bool changed = false;
+	view.each(Added<Static>(since), [&](Entity, Static &, Transform &, Model &) { changed = true; });
+	view.each(Added<Transform>(since), [&](Entity, Static &, Transform &, Model &) { changed = true; });
+	view.each(Added<Model>(since), [&](Entity, Static &, Transform &, Model &) { changed = true; });
+	return changed;
+}
+
+void SceneBVH::rebuild(Scene &scene, const TransformHierarchy &hierarchy) {
+	entities.clear();
+	indices.clear();
+
+	std::vector<AABB> bounds;
+	scene.view<Static, Transform, Model>().each([&](Entity entity, Static &, Transform &, Model &model) {
+		if (entity.id >= indices.size()) indices.resize(entity.id + 1, BVH_INVALID_INDEX);
+		indices[entity.id] = entities.size();
+		entities.push_back(entity);
+		bounds.push_back(model.getBounds().transformed(hierarchy.getWorldMatrix(entity)));
+	});
+	bvh.build(std::move(bounds), pool);
+}
+
+void SceneBVH::update(Scene &scene, const TransformHierarchy &hierarchy, Tick since) {
+	if (needsRebuild(scene, since)) {
+		rebuild(scene, hierarchy);
+		return;
+	}
+
+	scene.view<Static, Transform, Model>().each(Changed<Transform>(since), [&](Entity entity, Static &, Transform &, Model &model) {
+		bvh.update(indexOf(entity), model.getBounds().transformed(hierarchy.getWorldMatrix(entity)));
+	});
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "../util/bounds.hpp"
+#include "../util/bvh.hpp"
+#include "../util/frustum.hpp"
+#include "scene.hpp"
+#include "types.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+class TransformHierarchy;
+
+// Moves are found through `Changed<Transform>` on the entity itself, so static entities need static parents.
+class SceneBVH {
+	private:
+		BVH bvh {};
+		std::vector<Entity> entities {};
+		std::vector<uint32_t> indices {};
+		ThreadPool *pool;
+
+		bool needsRebuild(Scene &scene, Tick since);
+		void rebuild(Scene &scene, const TransformHierarchy &hierarchy);
+		uint32_t indexOf(Entity entity) const;
+
+	public:
+		SceneBVH(ThreadPool *pool = nullptr) : pool(pool) {};
+
+		// Call after `hierarchy` is updated for the same frame.
+		void update(Scene &scene, const TransformHierarchy &hierarchy, Tick since);
+
+		bool contains(Entity entity) const { return indexOf(entity) != BVH_INVALID_INDEX; };
+		size_t size() const { return entities.size(); };
+
+		template <typename F>
+		void queryFrustum(const Frustum &frustum, F &&fn) const {
+			bvh.queryFrustum(frustum, [&](uint32_t primitive, bool inside) { fn(entities[primitive], inside); });
+		};
+
+		template <typename F>
+		void queryAABB(const AABB &box, F &&fn) const {
+			bvh.queryAABB(box, [&](uint32_t primitive) { fn(entities[primitive]); });
+		};
+
+		template <typename F>
+		void querySphere(const BoundingSphere &sphere, F &&fn) const {
+			bvh.querySphere(sphere, [&](uint32_t primitive) { fn(entities[primitive]); });
+		};
+
+		template <typename F>
+		void queryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, F &&fn) const {
+			bvh.queryRay(origin, direction, maxDistance, [&](uint32_t primitive, float distance) { fn(entities[primitive], distance); });
+		};
+};
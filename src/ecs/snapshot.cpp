@@ -0,0 +1,129 @@
+#include "snapshot.hpp"
+
+#include <fstream>
+#include <sstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class MappedFile {
+	private:
+		const void *data = nullptr;
+		size_t size = 0;
+		#ifdef _WIN32
+			std::string buffer;
+		#endif
+
+	public:
+		MappedFile(const std::string &path) {
+			#ifdef _WIN32
+				std::ifstream file(path, std::ios::binary);
+				if (!file) throw std::runtime_error("Failed to open snapshot `" + path + "`.");
+				std::ostringstream contents;
+				contents << file.rdbuf();
+				buffer = contents.str();
+				data = buffer.data();
+				size = buffer.size();
+			#else
+				int fd = open(path.c_str(), O_RDONLY);
+				if (fd == -1) throw std::runtime_error("Failed to open snapshot `" + path + "`.");
+
+				struct stat info;
+				if (fstat(fd, &info) == -1) {
+					close(fd);
+					throw std::runtime_error("Failed to stat snapshot `" + path + "`.");
+				}
+
+				size = info.st_size;
+				if (size > 0) {
+					auto *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+					if (mapping == MAP_FAILED) {
+						close(fd);
+						throw std::runtime_error("Failed to map snapshot `" + path + "`.");
+					}
+					data = mapping;
+				}
+				close(fd);
+			#endif
+		};
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		~MappedFile() {
+			#ifndef _WIN32
+				if (data) munmap(const_cast<void *>(data), size);
+			#endif
+		};
+
+		SnapshotReader reader() const { return SnapshotReader(data, size); };
+};
+
+void Snapshot::save(Scene &scene, const std::string &path) const {
+	const auto &activeEntities = scene.getActiveEntities();
+	std::vector<uint32_t> indices;
+	for (size_t i = 0; i < activeEntities.size(); i++) {
+		auto id = activeEntities[i].id;
+		if (id >= indices.size()) indices.resize(id + 1);
+		indices[id] = i;
+	}
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) throw std::runtime_error("Failed to open snapshot `" + path + "` for writing.");
+	SnapshotWriter writer(file);
+
+	writer.write(SNAPSHOT_MAGIC);
+	writer.write(SNAPSHOT_VERSION);
+	writer.write<uint32_t>(activeEntities.size());
+	writer.write<uint32_t>(sections.size());
+
+	// Length-prefixed so a loader can skip unknown sections.
+	for (const auto &[name, section] : sections) {
+		std::ostringstream payload;
+		SnapshotWriter payloadWriter(payload);
+		section->save(scene, indices, payloadWriter);
+
+		auto bytes = payload.str();
+		writer.writeString(name);
+		writer.write<uint64_t>(bytes.size());
+		writer.writeBytes(bytes.data(), bytes.size());
+	}
+
+	if (!file) throw std::runtime_error("Failed to write snapshot `" + path + "`.");
+}
+
+std::vector<Entity> Snapshot::load(Scene &scene, const std::string &path) const {
+	MappedFile file(path);
+	auto reader = file.reader();
+
+	if (reader.read<uint32_t>() != SNAPSHOT_MAGIC)
+		throw std::runtime_error("`" + path + "` is not a snapshot.");
+	auto version = reader.read<uint32_t>();
+	if (version != SNAPSHOT_VERSION)
+		throw std::runtime_error("Snapshot `" + path + "` has version " + std::to_string(version) + ", expected " + std::to_string(SNAPSHOT_VERSION) + ".");
+
+	auto entities = scene.createEntities(reader.read<uint32_t>());
+	auto nSections = reader.read<uint32_t>();
+	std::vector<bool> loaded(sections.size(), false);
+	for (uint32_t i = 0; i < nSections; i++) {
+		auto name = reader.readString();
+		auto length = reader.read<uint64_t>();
+		SnapshotReader payload(reader.take(length), length);
+
+		for (size_t j = 0; j < sections.size(); j++) {
+			if (sections[j].first != name) continue;
+			sections[j].second->load(scene, entities, payload);
+			loaded[j] = true;
+			break;
+		}
+	}
+
+	for (size_t j = 0; j < sections.size(); j++) {
+		if (!loaded[j]) throw std::runtime_error("Snapshot `" + path + "` has no `" + sections[j].first + "` section.");
+	}
+
+	return entities;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "scene.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+const uint32_t SNAPSHOT_MAGIC = 0x50414e53; // "SNAP"
+// Bump when a snapshotted component layout or the registered set changes.
+const uint32_t SNAPSHOT_VERSION = 2;
+
+class SnapshotReader {
+	private:
+		const unsigned char *data;
+		size_t size;
+		size_t offset = 0;
+
+	public:
+		SnapshotReader(const void *data, size_t size) : data(static_cast<const unsigned char *>(data)), size(size) {};
+
+		size_t remaining() const { return size - offset; };
+
+		const unsigned char *take(size_t n) {
+			if (n > remaining()) throw std::runtime_error("Snapshot is truncated.");
+			auto *bytes = data + offset;
+			offset += n;
+			return bytes;
+		};
+
+		template <typename T>
+		T read() {
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be read directly.");
+			T value;
+			std::memcpy(&value, take(sizeof(T)), sizeof(T));
+			return value;
+		};
+
+		std::string readString() {
+			auto length = read<uint32_t>();
+			auto *bytes = take(length);
+			return std::string(reinterpret_cast<const char *>(bytes), length);
+		};
+};
+
+class SnapshotWriter {
+	private:
+		std::ostream &out;
+
+	public:
+		SnapshotWriter(std::ostream &out) : out(out) {};
+
+		void writeBytes(const void *bytes, size_t n) { out.write(static_cast<const char *>(bytes), n); };
+
+		template <typename T>
+		void write(const T &value) {
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be written directly.");
+			writeBytes(&value, sizeof(T));
+		};
+
+		void writeString(const std::string &value) {
+			write<uint32_t>(value.size());
+			writeBytes(value.data(), value.size());
+		};
+};
+
+class ISnapshotSection {
+	public:
+		virtual ~ISnapshotSection() = default;
+		virtual void save(Scene &scene, const std::vector<uint32_t> &indices, SnapshotWriter &writer) const = 0;
+		virtual void load(Scene &scene, const std::vector<Entity> &entities, SnapshotReader &reader) const = 0;
+};
+
+// Raw bytes in native byte order; entity handles inside are not remapped.
+template <typename T>
+class SnapshotComponent : public ISnapshotSection {
+	public:
+		void save(Scene &scene, const std::vector<uint32_t> &indices, SnapshotWriter &writer) const override {
+			std::vector<uint32_t> owners;
+			std::vector<T> components;
+			scene.each<T>([&](Entity entity, T &component) {
+				owners.push_back(indices[entity.id]);
+				components.push_back(component);
+			});
+
+			writer.write<uint32_t>(components.size());
+			writer.write<uint32_t>(sizeof(T));
+			writer.writeBytes(owners.data(), owners.size() * sizeof(uint32_t));
+			writer.writeBytes(components.data(), components.size() * sizeof(T));
+		};
+
+		void load(Scene &scene, const std::vector<Entity> &entities, SnapshotReader &reader) const override {
+			auto count = reader.read<uint32_t>();
+			if (reader.read<uint32_t>() != sizeof(T))
+				throw std::runtime_error("Snapshot component layout does not match this build.");
+			auto *owners = reader.take(count * sizeof(uint32_t));
+			auto *data = reader.take(count * sizeof(T));
+
+			std::vector<std::pair<Entity, ComponentStorage<T>>> components;
+			components.reserve(count);
+			for (size_t i = 0; i < count; i++) {
+				uint32_t owner;
+				std::memcpy(&owner, owners + i * sizeof(uint32_t), sizeof(uint32_t));
+				if (owner >= entities.size()) throw std::runtime_error("Snapshot references an unknown entity.");
+
+				// The mapping gives no alignment guarantee.
+				alignas(T) unsigned char component[sizeof(T)];
+				std::memcpy(component, data + i * sizeof(T), sizeof(T));
+				components.emplace_back(entities[owner], *reinterpret_cast<const T *>(component));
+			}
+			scene.addComponents<T>(components);
+		};
+};
+
+template <typename T>
+class SnapshotAsset : public ISnapshotSection {
+	private:
+		std::function<std::string (const T &asset)> toId;
+		std::function<std::shared_ptr<T> (const std::string &id)> fromId;
+
+	public:
+		SnapshotAsset(std::function<std::string (const T &asset)> toId, std::function<std::shared_ptr<T> (const std::string &id)> fromId)
+			: toId(std::move(toId)), fromId(std::move(fromId)) {};
+
+		void save(Scene &scene, const std::vector<uint32_t> &indices, SnapshotWriter &writer) const override {
+			std::unordered_map<const T *, uint32_t> ids;
+			std::vector<std::string> table;
+			std::vector<std::pair<uint32_t, uint32_t>> references;
+			scene.each<T>([&](Entity entity, T &asset) {
+				auto [it, inserted] = ids.try_emplace(&asset, table.size());
+				if (inserted) table.push_back(toId(asset));
+				references.push_back({indices[entity.id], it->second});
+			});
+
+			writer.write<uint32_t>(table.size());
+			for (const auto &id : table) writer.writeString(id);
+			writer.write<uint32_t>(references.size());
+			for (const auto &[owner, id] : references) {
+				writer.write(owner);
+				writer.write(id);
+			}
+		};
+
+		void load(Scene &scene, const std::vector<Entity> &entities, SnapshotReader &reader) const override {
+			std::vector<std::shared_ptr<T>> assets(reader.read<uint32_t>());
+			for (auto &asset : assets) asset = fromId(reader.readString());
+
+			auto count = reader.read<uint32_t>();
+			std::vector<std::pair<Entity, ComponentStorage<T>>> components;
+			components.reserve(count);
+			for (size_t i = 0; i < count; i++) {
+				auto owner = reader.read<uint32_t>();
+				auto id = reader.read<uint32_t>();
+				if (owner >= entities.size() || id >= assets.size())
+					throw std::runtime_error("Snapshot references an unknown entity or asset.");
+				components.emplace_back(entities[owner], assets[id]);
+			}
+			scene.addComponents<T>(components);
+		};
+};
+
+// Unknown sections are skipped on load; a missing registered section fails it.
+class Snapshot {
+	private:
+		std::vector<std::pair<std::string, std::unique_ptr<ISnapshotSection>>> sections {};
+
+	public:
+		template <typename T>
+		void registerComponent(const std::string &name) {
+			static_assert(!SharedComponent<T>::value, "Shared components must be registered as assets.");
+			static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable components can be snapshotted.");
+			sections.emplace_back(name, std::make_unique<SnapshotComponent<T>>());
+		};
+
+		template <typename T>
+		void registerAsset(
+			const std::string &name,
+			std::function<std::string (const T &asset)> toId,
+			std::function<std::shared_ptr<T> (const std::string &id)> fromId
+		) {
+			static_assert(SharedComponent<T>::value, "Only shared components can be registered as assets.");
+			sections.emplace_back(name, std::make_unique<SnapshotAsset<T>>(std::move(toId), std::move(fromId)));
+		};
+
+		void save(Scene &scene, const std::string &path) const;
+		// On failure `scene` may hold a partial load.
+		std::vector<Entity> load(Scene &scene, const std::string &path) const;
+};
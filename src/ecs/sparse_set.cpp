@@ -0,0 +1,32 @@
+#include "sparse_set.hpp"
+
+#include <memory>
+
+size_t &SparseSet::slot(EntityId id) {
+	auto page = id / SPARSE_PAGE_SIZE;
+	if (page >= sparse.size()) sparse.resize(page + 1);
+	if (!sparse[page]) {
+		sparse[page] = std::make_unique<Page>();
+		sparse[page]->fill(SPARSE_INVALID_INDEX);
+	}
+	return (*sparse[page])[id % SPARSE_PAGE_SIZE];
+}
+
+size_t SparseSet::insert(Entity entity) {
+	auto &index = slot(entity.id);
+	index = dense.size();
+	dense.push_back(entity);
+	return index;
+}
+
+size_t SparseSet::remove(Entity entity) {
+	auto &index = slot(entity.id);
+	auto removed = index;
+	auto last = dense.back();
+
+	dense[removed] = last;
+	slot(last.id) = removed;
+	dense.pop_back();
+	index = SPARSE_INVALID_INDEX;
+	return removed;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../util/paged_vector.hpp"
+#include "types.hpp"
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+const size_t SPARSE_PAGE_SIZE = 4096;
+const size_t SPARSE_INVALID_INDEX = std::numeric_limits<size_t>::max();
+
+class SparseSet {
+	private:
+		using Page = std::array<size_t, SPARSE_PAGE_SIZE>;
+
+		std::vector<std::unique_ptr<Page>> sparse {};
+		PagedVector<Entity, SPARSE_PAGE_SIZE> dense {};
+
+		size_t &slot(EntityId id);
+
+	public:
+		bool contains(Entity entity) const { return indexOf(entity) != SPARSE_INVALID_INDEX; };
+		size_t indexOf(Entity entity) const {
+			auto page = entity.id / SPARSE_PAGE_SIZE;
+			if (page >= sparse.size() || !sparse[page]) return SPARSE_INVALID_INDEX;
+			auto index = (*sparse[page])[entity.id % SPARSE_PAGE_SIZE];
+			if (index == SPARSE_INVALID_INDEX || dense[index].generation != entity.generation) return SPARSE_INVALID_INDEX;
+			return index;
+		};
+
+		size_t insert(Entity entity);
+		size_t remove(Entity entity);
+
+		// `move(from, to)` is called for each entry moved, so parallel arrays can follow.
+		template <typename F>
+		void removeAll(const std::vector<Entity> &entities, F &&move) {
+			std::vector<size_t> holes;
+			for (auto entity : entities) {
+				auto index = indexOf(entity);
+				if (index == SPARSE_INVALID_INDEX) continue;
+				slot(entity.id) = SPARSE_INVALID_INDEX;
+				holes.push_back(index);
+			}
+
+			auto end = dense.size();
+			for (auto hole : holes) {
+				if (hole >= end) continue;
+				while (end - 1 > hole && !contains(dense[end - 1])) end--;
+				if (end - 1 != hole) {
+					dense[hole] = dense[end - 1];
+					slot(dense[hole].id) = hole;
+					move(end - 1, hole);
+				}
+				end--;
+			}
+			while (dense.size() > end) dense.pop_back();
+		};
+		void reserve(size_t n) { dense.reserve(n); };
+
+		size_t size() const { return dense.size(); };
+		Entity operator[](size_t index) const { return dense[index]; };
+};
@@ -0,0 +1,49 @@
+#include "system.hpp"
+
+#include <exception>
+#include <mutex>
+
+void Scheduler::run(Scene &scene) {
+	// Created up front so concurrent systems never grow the scene's storage.
+	if (!prepared) {
+		for (auto &system : systems) system.prepare(scene);
+		prepared = true;
+	}
+
+	auto tick = scene.advanceTick();
+	std::vector<size_t> remaining(systems.size());
+	for (size_t i = 0; i < systems.size(); i++) remaining[i] = systems[i].nDependencies;
+
+	std::mutex mutex;
+	std::exception_ptr error;
+	std::function<void (size_t)> dispatch = [&](size_t i) {
+		pool.submit([&, i] {
+			try {
+				systems[i].run(scene, systems[i].commands, systems[i].lastRun);
+				systems[i].lastRun = tick;
+			} catch (...) {
+				std::lock_guard lock(mutex);
+				if (!error) error = std::current_exception();
+			}
+
+			std::vector<size_t> ready;
+			{
+				std::lock_guard lock(mutex);
+				for (auto dependent : systems[i].dependents) {
+					if (--remaining[dependent] == 0) ready.push_back(dependent);
+				}
+			}
+			for (auto dependent : ready) dispatch(dependent);
+		});
+	};
+
+	for (size_t i = 0; i < systems.size(); i++) {
+		if (systems[i].nDependencies == 0) dispatch(i);
+	}
+	pool.wait();
+
+	CommandBuffer commands;
+	for (auto &system : systems) commands.append(system.commands);
+	if (error) std::rethrow_exception(error);
+	commands.playback(scene);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../util/thread_pool.hpp"
+#include "command_buffer.hpp"
+#include "scene.hpp"
+#include "types.hpp"
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define MAX_ACCESS_TYPES 128
+
+// Kept apart from component types so resources don't use up `MAX_COMPONENTS`.
+using AccessSignature = std::bitset<MAX_ACCESS_TYPES>;
+
+inline size_t nextAccessType() {
+	static std::atomic<size_t> next = 0;
+	return next++;
+}
+
+template <typename T>
+size_t accessType() {
+	static const size_t type = nextAccessType();
+	return type;
+}
+
+template <typename... Ts>
+AccessSignature accessSignatureOf() {
+	AccessSignature signature;
+	(signature.set(accessType<Ts>()), ...);
+	return signature;
+}
+
+template <typename T>
+void registerAccess(Scene &scene) {
+	if constexpr (!Resource<T>::value) scene.registerComponent<T>();
+}
+
+// Systems whose accesses conflict run in registration order; others may run concurrently.
+template <typename... Ts>
+struct Read {
+	static AccessSignature signature() { return accessSignatureOf<Ts...>(); };
+	static void registerWith(Scene &scene) { (registerAccess<Ts>(scene), ...); };
+};
+
+template <typename... Ts>
+struct Write {
+	static AccessSignature signature() { return accessSignatureOf<Ts...>(); };
+	static void registerWith(Scene &scene) { (registerAccess<Ts>(scene), ...); };
+};
+
+// Structural changes go through `commands`; `lastRun` is the tick of the previous run, 0 on the first.
+using SystemFunction = std::function<void (Scene &scene, CommandBuffer &commands, Tick lastRun)>;
+
+struct System {
+	std::string name;
+	AccessSignature reads;
+	AccessSignature writes;
+	SystemFunction run;
+	std::function<void (Scene &scene)> prepare;
+	CommandBuffer commands {};
+	Tick lastRun = 0;
+
+	std::vector<size_t> dependents {};
+	size_t nDependencies = 0;
+
+	bool conflicts(const System &other) const {
+		return (writes & (other.reads | other.writes)).any() || (reads & other.writes).any();
+	};
+};
+
+class Scheduler {
+	private:
+		std::vector<System> systems {};
+		ThreadPool &pool;
+		bool prepared = false;
+
+	public:
+		Scheduler(ThreadPool &pool) : pool(pool) {};
+
+		template <typename R = Read<>, typename W = Write<>>
+		void addSystem(const std::string &name, SystemFunction run) {
+			System system {
+				.name = name,
+				.reads = R::signature(),
+				.writes = W::signature(),
+				.run = std::move(run),
+				.prepare = [](Scene &scene) {
+					R::registerWith(scene);
+					W::registerWith(scene);
+				},
+			};
+
+			for (size_t i = 0; i < systems.size(); i++) {
+				if (systems[i].conflicts(system)) {
+					systems[i].dependents.push_back(systems.size());
+					system.nDependencies++;
+				}
+			}
+
+			systems.push_back(std::move(system));
+			prepared = false;
+		};
+
+		void run(Scene &scene);
+};
@@ -1,13 +1,83 @@
 #pragma once
 
-#include <map>
-#include <optional>
+#include <atomic>
+#include <bitset>
+#include <limits>
+#include <memory>
+#include <type_traits>
 
-#define MAX_ENTITIES 1024
-
-class Entity;
+#define MAX_COMPONENTS 64
 
 using EntityId = unsigned int;
+using EntityGeneration = unsigned int;
+using ComponentType = unsigned int;
+using Signature = std::bitset<MAX_COMPONENTS>;
+using Tick = unsigned int;
+
+const EntityId INVALID_ENTITY = std::numeric_limits<EntityId>::max();
+
+struct Entity {
+	EntityId id = INVALID_ENTITY;
+	EntityGeneration generation = 0;
+
+	bool operator==(const Entity &rhs) const { return id == rhs.id && generation == rhs.generation; };
+	bool operator!=(const Entity &rhs) const { return !(*this == rhs); };
+};
+
+struct ComponentTicks {
+	Tick added = 0;
+	Tick changed = 0;
+};
+
+// `since` is when the querying system last ran; a change in that same tick may be reported twice.
+template <typename T>
+struct Added {
+	using Component = T;
+	Tick since;
+
+	Added(Tick since) : since(since) {};
+	bool matches(const ComponentTicks &ticks) const { return ticks.added >= since; };
+};
+
+template <typename T>
+struct Changed {
+	using Component = T;
+	Tick since;
+
+	Changed(Tick since) : since(since) {};
+	bool matches(const ComponentTicks &ticks) const { return ticks.changed >= since; };
+};
+
+inline ComponentType nextComponentType() {
+	static std::atomic<ComponentType> next = 0;
+	return next++;
+}
+
+template <typename T>
+ComponentType componentType() {
+	static const ComponentType type = nextComponentType();
+	return type;
+}
+
+template <typename... Ts>
+Signature signatureOf() {
+	Signature signature;
+	(signature.set(componentType<Ts>()), ...);
+	return signature;
+}
+
+template <typename T>
+struct SharedComponent : std::false_type {};
+
+template <typename T>
+using ComponentStorage = std::conditional_t<SharedComponent<T>::value, std::shared_ptr<T>, T>;
+
+template <typename T>
+T *componentPointer(T &component) { return &component; }
+
+template <typename T>
+T *componentPointer(std::shared_ptr<T> &component) { return component.get(); }
 
+// Per-frame state that systems declare for scheduling but that isn't stored in the scene.
 template <typename T>
-using OptionalComponent = std::optional<std::shared_ptr<T>>;
+struct Resource : std::false_type {};
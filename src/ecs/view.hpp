@@ -0,0 +1,84 @@
+#pragma once
+
+#include "sparse_set.hpp"
+#include "types.hpp"
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+
+template <typename T>
+class ComponentArray;
+
+struct EntityGroup {
+	Signature signature;
+	SparseSet entities {};
+
+	EntityGroup(Signature signature) : signature(signature) {};
+	bool matches(Signature other) const { return (other & signature) == signature; };
+};
+
+template <typename... Ts>
+class View {
+	private:
+		const SparseSet &entities;
+		std::tuple<ComponentArray<Ts> *...> componentArrays;
+
+	public:
+		using Value = std::tuple<Entity, Ts&...>;
+
+		struct Iterator {
+			using value_type = Value;
+			using reference = value_type;
+			using pointer = void;
+			using difference_type = std::ptrdiff_t;
+			using iterator_category	= std::forward_iterator_tag;
+
+			const View *view;
+			size_t index;
+
+			Iterator(const View *view, size_t index) : view(view), index(index) {};
+
+			reference operator*() const { return view->get(index); };
+
+			Iterator& operator++() { index++; return *this; };
+			Iterator operator++(int) { Iterator i(*this); ++(*this); return i; };
+
+			bool operator==(const Iterator &rhs) const { return index == rhs.index; };
+			bool operator!=(const Iterator &rhs) const { return index != rhs.index; };
+		};
+
+		View(const SparseSet &entities, ComponentArray<Ts> *...componentArrays) : entities(entities), componentArrays(componentArrays...) {};
+
+		Value get(size_t index) const {
+			auto entity = entities[index];
+			return Value(entity, *std::get<ComponentArray<Ts> *>(componentArrays)->getData(entity)...);
+		};
+
+		size_t size() const { return entities.size(); };
+		bool empty() const { return entities.size() == 0; };
+
+		Iterator begin() const { return Iterator(this, 0); };
+		Iterator end() const { return Iterator(this, entities.size()); };
+
+		template <typename F>
+		void each(F &&fn) const {
+			for (size_t i = 0; i < entities.size(); i++) {
+				auto entity = entities[i];
+				fn(entity, *std::get<ComponentArray<Ts> *>(componentArrays)->getData(entity)...);
+			}
+		};
+
+		template <typename Filter, typename F>
+		void each(const Filter &filter, F &&fn) const {
+			using Component = typename Filter::Component;
+			static_assert((std::is_same_v<Component, Ts> || ...), "Filtered component must be part of the view.");
+
+			auto *filtered = std::get<ComponentArray<Component> *>(componentArrays);
+			for (size_t i = 0; i < entities.size(); i++) {
+				auto entity = entities[i];
+				if (!filter.matches(*filtered->getTicks(entity))) continue;
+				fn(entity, *std::get<ComponentArray<Ts> *>(componentArrays)->getData(entity)...);
+			}
+		};
+};
@@ -0,0 +1,36 @@
+#include "buffer_texture.hpp"
+
+#include "gl_state.hpp"
+#include <stdexcept>
+#include <string>
+
+BufferTexture::BufferTexture(GLState &state, unsigned int unit, GLenum format, size_t texelSize) : unit(unit), texelSize(texelSize) {
+	GLint max;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &max);
+	maxTexels = max;
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	glGenTextures(1, &texture);
+	state.setActiveTexture(unit);
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+}
+
+BufferTexture::~BufferTexture() {
+	glDeleteTextures(1, &texture);
+	glDeleteBuffers(1, &buffer);
+}
+
+void BufferTexture::update(const void *data, size_t size) {
+	if (size / texelSize > maxTexels)
+		throw std::length_error(std::to_string(size / texelSize) + " texels overflow a buffer texture of at most " + std::to_string(maxTexels) + ".");
+
+	// Respecified so the driver can orphan storage the last frame still reads.
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	glBufferData(GL_TEXTURE_BUFFER, size, data, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
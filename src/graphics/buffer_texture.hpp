@@ -0,0 +1,25 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+class GLState;
+
+// Kept bound to a fixed texture unit for arrays too large for a uniform block.
+class BufferTexture {
+	private:
+		GLuint buffer;
+		GLuint texture;
+		unsigned int unit;
+		size_t texelSize;
+		size_t maxTexels;
+
+	public:
+		BufferTexture(GLState &state, unsigned int unit, GLenum format, size_t texelSize);
+		BufferTexture(const BufferTexture &) = delete;
+		BufferTexture &operator=(const BufferTexture &) = delete;
+		~BufferTexture();
+
+		unsigned int getUnit() const { return unit; };
+		void update(const void *data, size_t size);
+};
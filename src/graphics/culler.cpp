@@ -0,0 +1,74 @@
+#include "culler.hpp"
+
+#include "../util/bounds.hpp"
+#include "../util/occlusion.hpp"
+#include "mesh.hpp"
+#include "model.hpp"
+#include "render_queue.hpp"
+#include <memory>
+
+void FrustumCuller::clear() {
+	models.clear();
+	visibleModels.clear();
+	modelBounds.clear();
+}
+
+void FrustumCuller::add(const Model &model, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix) {
+	models.push_back({ &model, &shader, modelMatrix, normalMatrix, false });
+	modelBounds.push(model.getBounds().transformed(modelMatrix), model.getSphere().transformed(modelMatrix));
+}
+
+void FrustumCuller::addVisible(const Model &model, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix, bool inside) {
+	visibleModels.push_back({ &model, &shader, modelMatrix, normalMatrix, inside });
+}
+
+void FrustumCuller::cull(const glm::mat4 &view, const glm::mat4 &projection, RenderQueue &queue, const OcclusionBuffer *occlusion) {
+	auto viewProjection = projection * view;
+	Frustum frustum(viewProjection);
+	stats = {};
+	stats.models = models.size() + visibleModels.size();
+
+	visible.resize(modelBounds.size());
+	cullBounds(frustum, modelBounds.getArrays(), visible.data());
+	for (size_t i = 0; i < models.size(); i++) {
+		if (visible[i]) visibleModels.push_back(models[i]);
+	}
+
+	meshes.clear();
+	meshBounds.clear();
+	for (size_t i = 0; i < visibleModels.size(); i++) {
+		const auto &item = visibleModels[i];
+		const auto &modelMeshes = item.model->getMeshes();
+		if (occlusion && !occlusion->isVisible(item.model->getBounds().transformed(item.modelMatrix), viewProjection)) {
+			stats.occludedModels++;
+			continue;
+		}
+		stats.visibleModels++;
+		stats.meshes += modelMeshes.size();
+
+		// A single mesh has the model's bounds, which already passed.
+		if (item.inside || modelMeshes.size() == 1) {
+			for (const auto &mesh : modelMeshes) queue.push(*mesh, *item.shader, item.modelMatrix, item.normalMatrix, view);
+			stats.visibleMeshes += modelMeshes.size();
+			continue;
+		}
+		for (const auto &mesh : modelMeshes) {
+			meshes.push_back({ mesh.get(), i });
+			meshBounds.push(mesh->getBounds().transformed(item.modelMatrix), mesh->getSphere().transformed(item.modelMatrix));
+		}
+	}
+
+	visible.resize(meshBounds.size());
+	cullBounds(frustum, meshBounds.getArrays(), visible.data());
+
+	for (size_t i = 0; i < meshes.size(); i++) {
+		if (!visible[i]) continue;
+		const auto &item = visibleModels[meshes[i].model];
+		if (occlusion && !occlusion->isVisible(meshes[i].mesh->getBounds().transformed(item.modelMatrix), viewProjection)) {
+			stats.occludedMeshes++;
+			continue;
+		}
+		queue.push(*meshes[i].mesh, *item.shader, item.modelMatrix, item.normalMatrix, view);
+		stats.visibleMeshes++;
+	}
+}
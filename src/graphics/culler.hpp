@@ -0,0 +1,55 @@
+#pragma once
+
+#include "../util/frustum.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+class Mesh;
+class Model;
+class OcclusionBuffer;
+class RenderQueue;
+class ShaderProgram;
+
+// `meshes` counts the meshes of visible models.
+struct CullStats {
+	size_t models;
+	size_t visibleModels;
+	size_t meshes;
+	size_t visibleMeshes;
+	size_t occludedModels;
+	size_t occludedMeshes;
+};
+
+class FrustumCuller {
+	private:
+		struct ModelItem {
+			const Model *model;
+			const ShaderProgram *shader;
+			glm::mat4 modelMatrix;
+			glm::mat3 normalMatrix;
+			bool inside;
+		};
+
+		struct MeshItem {
+			const Mesh *mesh;
+			size_t model;
+		};
+
+		std::vector<ModelItem> models {};
+		std::vector<ModelItem> visibleModels {};
+		std::vector<MeshItem> meshes {};
+		BoundsBatch modelBounds {};
+		BoundsBatch meshBounds {};
+		std::vector<unsigned char> visible {};
+		CullStats stats {};
+
+	public:
+		void clear();
+		void add(const Model &model, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix);
+		// `inside` models are entirely visible, so their meshes aren't tested.
+		void addVisible(const Model &model, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix, bool inside);
+		void cull(const glm::mat4 &view, const glm::mat4 &projection, RenderQueue &queue, const OcclusionBuffer *occlusion = nullptr);
+
+		const CullStats &getStats() const { return stats; };
+};
@@ -0,0 +1,82 @@
+#include "g_buffer.hpp"
+
+#include "gl_state.hpp"
+#include "shader.hpp"
+#include <glad/glad.h>
+#include <stdexcept>
+
+GBuffer::GBuffer(GLState &state) : state(state) {
+	glGenFramebuffers(1, &framebuffer);
+	glGenVertexArrays(1, &emptyVertexArray);
+
+	const GLuint units[] = { TEXTURE_UNIT_G_ALBEDO, TEXTURE_UNIT_G_SPECULAR, TEXTURE_UNIT_G_NORMAL, TEXTURE_UNIT_G_DEPTH };
+	GLuint *textures[] = { &albedo, &specular, &normal, &depth };
+	for (int i = 0; i < 4; i++) {
+		glGenTextures(1, textures[i]);
+		state.bindTexture(units[i], *textures[i]);
+		// A mipmapped filter would leave the textures incomplete.
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedo, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, specular, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D, normal, 0);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, depth, 0);
+	const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+	glDrawBuffers(3, drawBuffers);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+GBuffer::~GBuffer() {
+	glDeleteFramebuffers(1, &framebuffer);
+	state.deleteVertexArray(emptyVertexArray);
+	const GLuint textures[] = { albedo, specular, normal, depth };
+	glDeleteTextures(4, textures);
+}
+
+void GBuffer::resize(unsigned int width, unsigned int height) {
+	if (width == this->width && height == this->height) return;
+	this->width = width;
+	this->height = height;
+
+	state.bindTexture(TEXTURE_UNIT_G_ALBEDO, albedo);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	state.bindTexture(TEXTURE_UNIT_G_SPECULAR, specular);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	state.bindTexture(TEXTURE_UNIT_G_NORMAL, normal);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+	// Packed with stencil to match the default framebuffer for `blitDepth`.
+	state.bindTexture(TEXTURE_UNIT_G_DEPTH, depth);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8, nullptr);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	if (status != GL_FRAMEBUFFER_COMPLETE) throw std::runtime_error("G-buffer framebuffer is incomplete.");
+}
+
+void GBuffer::bind() const {
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void GBuffer::drawLightPass(const ShaderProgram &lightPass) const {
+	state.bindTexture(TEXTURE_UNIT_G_ALBEDO, albedo);
+	state.bindTexture(TEXTURE_UNIT_G_SPECULAR, specular);
+	state.bindTexture(TEXTURE_UNIT_G_NORMAL, normal);
+	state.bindTexture(TEXTURE_UNIT_G_DEPTH, depth);
+
+	state.setDepthTest(false);
+	lightPass.use();
+	state.bindVertexArray(emptyVertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	state.setDepthTest(true);
+}
+
+void GBuffer::blitDepth() const {
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
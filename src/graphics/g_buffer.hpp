@@ -0,0 +1,33 @@
+#pragma once
+
+#include <glad/glad.h>
+
+class GLState;
+class ShaderProgram;
+
+const unsigned int TEXTURE_UNIT_G_ALBEDO = 9;
+const unsigned int TEXTURE_UNIT_G_SPECULAR = 10;
+const unsigned int TEXTURE_UNIT_G_NORMAL = 11;
+const unsigned int TEXTURE_UNIT_G_DEPTH = 12;
+
+// Specular alpha holds shininess / 256; positions are rebuilt from depth.
+class GBuffer {
+	private:
+		GLState &state;
+		GLuint framebuffer;
+		GLuint albedo, specular, normal, depth;
+		GLuint emptyVertexArray;
+		unsigned int width = 0;
+		unsigned int height = 0;
+
+	public:
+		GBuffer(GLState &state);
+		GBuffer(const GBuffer &) = delete;
+		GBuffer &operator=(const GBuffer &) = delete;
+		~GBuffer();
+
+		void resize(unsigned int width, unsigned int height);
+		void bind() const;
+		void drawLightPass(const ShaderProgram &lightPass) const;
+		void blitDepth() const;
+};
@@ -0,0 +1,26 @@
+#include "gl_state.hpp"
+
+#include <glad/glad.h>
+#include <stdexcept>
+
+void GLState::setActiveTexture(unsigned int unit) {
+	if (unit >= GL_STATE_TEXTURE_UNITS) throw std::out_of_range("Texture unit out of range.");
+	if (change(activeTexture, unit)) glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+bool GLState::bindTexture(unsigned int unit, GLuint id) {
+	if (unit >= GL_STATE_TEXTURE_UNITS) throw std::out_of_range("Texture unit out of range.");
+	if (textures[unit] == id) {
+		stats.elided++;
+		return false;
+	}
+	setActiveTexture(unit);
+	change(textures[unit], id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	return true;
+}
+
+void GLState::deleteVertexArray(GLuint id) {
+	glDeleteVertexArrays(1, &id);
+	if (vertexArray == id) vertexArray = 0;
+}
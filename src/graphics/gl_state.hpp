@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <array>
+#include <cstddef>
+
+const unsigned int GL_STATE_TEXTURE_UNITS = 32;
+
+struct GLStateStats {
+	size_t issued;
+	size_t elided;
+};
+
+// Starts from GL's defaults, so all tracked state changes must go through it.
+class GLState {
+	private:
+		GLuint program = 0;
+		GLuint vertexArray = 0;
+		unsigned int activeTexture = 0;
+		std::array<GLuint, GL_STATE_TEXTURE_UNITS> textures {};
+		GLenum polygonMode = GL_FILL;
+		bool depthTest = false;
+		GLenum depthFunc = GL_LESS;
+		bool depthMask = true;
+		bool cullFace = false;
+		GLenum cullFaceMode = GL_BACK;
+		GLStateStats stats {};
+
+		template <typename T>
+		bool change(T &current, T value) {
+			if (current == value) {
+				stats.elided++;
+				return false;
+			}
+			current = value;
+			stats.issued++;
+			return true;
+		};
+
+	public:
+		void useProgram(GLuint id) { if (change(program, id)) glUseProgram(id); };
+		void bindVertexArray(GLuint id) { if (change(vertexArray, id)) glBindVertexArray(id); };
+		void setActiveTexture(unsigned int unit);
+		bool bindTexture(unsigned int unit, GLuint id);
+		void setPolygonMode(GLenum mode) { if (change(polygonMode, mode)) glPolygonMode(GL_FRONT_AND_BACK, mode); };
+		void setDepthTest(bool enabled) { if (change(depthTest, enabled)) enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST); };
+		void setDepthFunc(GLenum func) { if (change(depthFunc, func)) glDepthFunc(func); };
+		void setDepthMask(bool enabled) { if (change(depthMask, enabled)) glDepthMask(enabled); };
+		void setCullFace(bool enabled) { if (change(cullFace, enabled)) enabled ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE); };
+		void setCullFaceMode(GLenum mode) { if (change(cullFaceMode, mode)) glCullFace(mode); };
+
+		void deleteVertexArray(GLuint id);
+
+		void resetStats() { stats = {}; };
+		const GLStateStats &getStats() const { return stats; };
+};
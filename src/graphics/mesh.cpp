@@ -1,13 +1,20 @@
 #include "mesh.hpp"
 
+#include "../context.hpp"
+#include "../util/hash.hpp"
+#include "gl_state.hpp"
 #include "shader.hpp"
 #include "texture.hpp"
 #include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <stddef.h>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 const std::string textureTypeToString(TextureType type) {
 	switch (type) {
@@ -19,17 +26,45 @@ const std::string textureTypeToString(TextureType type) {
 }
 
 Mesh::~Mesh() {
-	glDeleteVertexArrays(1, &VAO);
+	ctx.glState.deleteVertexArray(VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
 }
 
+void Mesh::computeBounds() {
+	for (const auto &vertex : vertices) bounds.add(vertex.position);
+
+	sphere.center = bounds.getCenter();
+	for (const auto &vertex : vertices) sphere.radius = std::max(sphere.radius, glm::distance(sphere.center, vertex.position));
+}
+
 void Mesh::setupMesh() {
+	for (const auto &texture : textures) textureIds.push_back(texture->getId());
+
+	unsigned int diffuseN = 0;
+	unsigned int specularN = 0;
+	for (const auto &texture : textures) {
+		auto type = texture->getType();
+
+		std::string number;
+		switch (type) {
+			case DIFFUSE:
+				number = std::to_string(diffuseN++);
+				break;
+			case SPECULAR:
+				number = std::to_string(specularN++);
+				break;
+		}
+
+		auto name = "material.tex" + textureTypeToString(type) + number;
+		samplers.push_back(hashString(name.c_str(), name.size()));
+	}
+
 	glGenVertexArrays(1, &VAO);
 	glGenBuffers(1, &VBO);
 	glGenBuffers(1, &EBO);
 
-	glBindVertexArray(VAO);
+	ctx.glState.bindVertexArray(VAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
 	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
@@ -47,35 +82,23 @@ void Mesh::setupMesh() {
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride, (GLvoid*) offsetof(Vertex, texCoords));
 	glEnableVertexAttribArray(2);
 
-	glBindVertexArray(0);
+	// Unbound so later element buffer binds can't land in this VAO.
+	ctx.glState.bindVertexArray(0);
 }
 
-void Mesh::draw(std::shared_ptr<ShaderProgram> shader) {
-	unsigned int diffuseN = 0;
-	unsigned int specularN = 0;
+size_t Mesh::bindTextures(const ShaderProgram &shader) const {
+	size_t nBound = 0;
 	for (unsigned int i = 0; i < textures.size(); i++) {
-		auto texture = textures[i];
-		auto type = textures[i]->getType();
-		texture->use(GL_TEXTURE0 + i);
-
-		std::string number;
-		switch (type) {
-			case DIFFUSE:
-				number = std::to_string(diffuseN++);
-				break;
-			case SPECULAR:
-				number = std::to_string(specularN++);
-				break;
-		}
-
-		auto str = "material.tex" + textureTypeToString(type) + number;
-		shader->tryUniformInt(str.c_str(), i);
-		texture->use(GL_TEXTURE0 + i);
+		shader.tryUniform<int>(UniformName(samplers[i])).set(i);
+		if (textures[i]->use(ctx.glState, i)) nBound++;
 	}
+	return nBound;
+}
 
-	glBindVertexArray(VAO);
-	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+void Mesh::draw(const ShaderProgram &shader) {
+	shader.use();
+	bindTextures(shader);
 
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(0);
+	ctx.glState.bindVertexArray(VAO);
+	glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
 }
\ No newline at end of file
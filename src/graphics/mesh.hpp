@@ -1,7 +1,10 @@
 #pragma once
 
+#include "../util/bounds.hpp"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
@@ -19,7 +22,12 @@ class Mesh {
 	private:
 		Context &ctx;
 		GLuint VAO, VBO, EBO;
+		std::vector<GLuint> textureIds;
+		std::vector<uint32_t> samplers;
+		AABB bounds;
+		BoundingSphere sphere;
 		void setupMesh();
+		void computeBounds();
 
 	public:
 		std::vector<Vertex> vertices;
@@ -32,9 +40,18 @@ class Mesh {
 			std::vector<unsigned int> indices,
 			std::vector<std::shared_ptr<Texture>> textures
 		) : ctx(ctx), vertices(vertices), indices(indices), textures(textures) {
+			computeBounds();
 			setupMesh();
 		};
 		~Mesh();
 
-		void draw(std::shared_ptr<ShaderProgram> shader);
+		const AABB &getBounds() const { return bounds; };
+		const BoundingSphere &getSphere() const { return sphere; };
+		GLuint getVAO() const { return VAO; };
+		GLsizei getIndexCount() const { return indices.size(); };
+		const std::vector<GLuint> &getTextureIds() const { return textureIds; };
+
+		// `shader` must be in use; returns the number of textures actually bound.
+		size_t bindTextures(const ShaderProgram &shader) const;
+		void draw(const ShaderProgram &shader);
 };
\ No newline at end of file
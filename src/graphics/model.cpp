@@ -14,13 +14,16 @@
 #include <assimp/types.h>
 #include <assimp/vector3.h>
 
+#include <glm/glm.hpp>
+
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 
-void Model::draw(std::shared_ptr<ShaderProgram> shader) {
+void Model::draw(const ShaderProgram &shader) {
 	for (const auto &mesh : meshes) {
 		mesh->draw(shader);
 	}
@@ -38,6 +41,18 @@ void Model::loadModel(const std::string &path) {
 
 	dir = path.substr(0, path.find_last_of('/'));
 	processNode(scene->mRootNode, scene);
+	computeBounds();
+}
+
+void Model::computeBounds() {
+	for (const auto &mesh : meshes) bounds.add(mesh->getBounds());
+
+	sphere.center = bounds.getCenter();
+	for (const auto &mesh : meshes) {
+		const auto &meshSphere = mesh->getSphere();
+		sphere.radius = std::max(sphere.radius, glm::distance(sphere.center, meshSphere.center) + meshSphere.radius);
+	}
+	sphere.radius = std::min(sphere.radius, glm::length(bounds.getExtents()));
 }
 
 void Model::processNode(aiNode *node, const aiScene *scene) {
@@ -122,7 +137,7 @@ std::vector<std::shared_ptr<Texture>> Model::loadMaterialTextures(aiMaterial *ma
 					throw std::invalid_argument("Texture type is not yet supported.");
 			}
 
-			auto texture = std::make_shared<Texture>(dir + "/" + filename, enumType);
+			auto texture = std::make_shared<Texture>(ctx.glState, dir + "/" + filename, enumType);
 			ctx.textures.set(filename, texture);
 			textureOpt = ctx.textures.get(filename);
 		}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "../ecs/types.hpp"
+#include "../util/bounds.hpp"
 #include "mesh.hpp"
 #include <assimp/material.h>
 #include <iosfwd>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 class Context;
@@ -18,13 +21,22 @@ class Model {
 		Context &ctx;
 		std::vector<std::unique_ptr<Mesh>> meshes;
 		std::string dir;
+		AABB bounds;
+		BoundingSphere sphere;
 
 		void loadModel(const std::string &path);
 		void processNode(aiNode *node, const aiScene *scene);
 		std::unique_ptr<Mesh> processMesh(aiMesh *mesh, const aiScene *scene);
 		std::vector<std::shared_ptr<Texture>> loadMaterialTextures(aiMaterial *mat, aiTextureType type);
+		void computeBounds();
 
 	public:
 		Model(Context &ctx, const std::string &path) : ctx(ctx) { loadModel(path); };
-		void draw(std::shared_ptr<ShaderProgram> shader);
-};
\ No newline at end of file
+		void draw(const ShaderProgram &shader);
+		const std::vector<std::unique_ptr<Mesh>> &getMeshes() const { return meshes; };
+		const AABB &getBounds() const { return bounds; };
+		const BoundingSphere &getSphere() const { return sphere; };
+};
+
+template <>
+struct SharedComponent<Model> : std::true_type {};
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "render_queue.hpp"
+
+#include "gl_state.hpp"
+#include "mesh.hpp"
+#include "model.hpp"
+#include "shader.hpp"
+#include <glad/glad.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+constexpr UniformName MODEL_UNIFORM = "model";
+constexpr UniformName NORMAL_MATRIX_UNIFORM = "normalMatrix";
+
+template <typename Map, typename Key>
+uint32_t denseId(Map &ids, const Key &key, unsigned int bits, const char *what) {
+	auto it = ids.find(key);
+	if (it != ids.end()) return it->second;
+	if (ids.size() >= (size_t(1) << bits)) throw std::length_error(std::string("Too many ") + what + " in render queue.");
+	uint32_t id = ids.size();
+	ids.emplace(key, id);
+	return id;
+}
+
+uint64_t RenderQueue::makeKey(const Mesh &mesh, const ShaderProgram &shader, float depth) {
+	uint64_t program = denseId(programs, &shader, RENDER_KEY_PROGRAM_BITS, "shader programs");
+	uint64_t material = denseId(materials, mesh.getTextureIds(), RENDER_KEY_MATERIAL_BITS, "materials");
+	uint64_t vao = denseId(vaos, mesh.getVAO(), RENDER_KEY_VAO_BITS, "vertex arrays");
+
+	const uint64_t maxDepth = (uint64_t(1) << RENDER_KEY_DEPTH_BITS) - 1;
+	uint64_t quantizedDepth = std::clamp(depth / farPlane, 0.0f, 1.0f) * maxDepth;
+
+	return program << (RENDER_KEY_MATERIAL_BITS + RENDER_KEY_VAO_BITS + RENDER_KEY_DEPTH_BITS)
+		| material << (RENDER_KEY_VAO_BITS + RENDER_KEY_DEPTH_BITS)
+		| vao << RENDER_KEY_DEPTH_BITS
+		| quantizedDepth;
+}
+
+void RenderQueue::setInstancedVariant(const ShaderProgram &shader, const ShaderProgram &instanced) {
+	instancedVariants[&shader] = &instanced;
+}
+
+void RenderQueue::setSubstitute(const ShaderProgram &shader, const ShaderProgram &substitute) {
+	substitutes[&shader] = &substitute;
+}
+
+void RenderQueue::clear() {
+	items.clear();
+	entries.clear();
+	programs.clear();
+	materials.clear();
+	vaos.clear();
+	groupSizes.clear();
+	stats = {};
+}
+
+void RenderQueue::push(const Model &model, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix, const glm::mat4 &view) {
+	for (const auto &mesh : model.getMeshes()) push(*mesh, shader, modelMatrix, normalMatrix, view);
+}
+
+void RenderQueue::push(const Mesh &mesh, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix, const glm::mat4 &view) {
+	float depth = -(view * modelMatrix[3]).z;
+	auto substitute = substitutes.find(&shader);
+	const auto *queued = substitute != substitutes.end() ? substitute->second : &shader;
+	items.push_back({ &mesh, queued, modelMatrix, normalMatrix, depth, queued, false });
+	groupSizes[{ queued, &mesh }]++;
+}
+
+void RenderQueue::sort() {
+	// Instanced items take their variant's program id so each group stays contiguous.
+	entries.resize(items.size());
+	for (uint32_t i = 0; i < items.size(); i++) {
+		auto &item = items[i];
+		auto variant = instancedVariants.find(item.shader);
+		item.instanced = variant != instancedVariants.end() && groupSizes[{ item.shader, item.mesh }] >= RENDER_INSTANCING_THRESHOLD;
+		item.program = item.instanced ? variant->second : item.shader;
+		entries[i] = { makeKey(*item.mesh, *item.program, item.depth), i };
+	}
+
+	scratch.resize(entries.size());
+	for (unsigned int shift = 0; shift < 64; shift += 8) {
+		std::array<size_t, 256> offsets {};
+		for (const auto &entry : entries) offsets[(entry.key >> shift) & 0xff]++;
+		if (std::any_of(offsets.begin(), offsets.end(), [&](size_t count) { return count == entries.size(); })) continue;
+
+		size_t offset = 0;
+		for (auto &count : offsets) {
+			auto next = offset + count;
+			count = offset;
+			offset = next;
+		}
+		for (const auto &entry : entries) scratch[offsets[(entry.key >> shift) & 0xff]++] = entry;
+		std::swap(entries, scratch);
+	}
+}
+
+void RenderQueue::bindInstances(size_t first) {
+	const GLsizei stride = sizeof(Instance);
+	auto base = first * sizeof(Instance);
+	for (GLuint column = 0; column < 4; column++) {
+		auto location = RENDER_INSTANCE_MODEL_LOCATION + column;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*) (base + offsetof(Instance, modelMatrix) + column * sizeof(glm::vec4)));
+		glVertexAttribDivisor(location, 1);
+	}
+	for (GLuint column = 0; column < 3; column++) {
+		auto location = RENDER_INSTANCE_NORMAL_LOCATION + column;
+		glEnableVertexAttribArray(location);
+		glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*) (base + offsetof(Instance, normalMatrix) + column * sizeof(glm::vec3)));
+		glVertexAttribDivisor(location, 1);
+	}
+}
+
+// The attributes live in the mesh's own VAO, so plain draws of it must not see them.
+void RenderQueue::unbindInstances() {
+	for (GLuint column = 0; column < 4; column++) glDisableVertexAttribArray(RENDER_INSTANCE_MODEL_LOCATION + column);
+	for (GLuint column = 0; column < 3; column++) glDisableVertexAttribArray(RENDER_INSTANCE_NORMAL_LOCATION + column);
+}
+
+void RenderQueue::submit(GLState &state, const std::function<bool(const ShaderProgram &)> &filter) {
+	instances.clear();
+	for (const auto &entry : entries) {
+		const auto &item = items[entry.item];
+		if (item.instanced && (!filter || filter(*item.shader))) instances.push_back({ item.modelMatrix, item.normalMatrix });
+	}
+	if (!instances.empty()) {
+		if (!instanceBuffer.id) glGenBuffers(1, &instanceBuffer.id);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.id);
+		glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STREAM_DRAW);
+	}
+
+	const ShaderProgram *program = nullptr;
+	uint64_t material = 0;
+	GLuint vao = 0;
+	size_t nInstanced = 0;
+	Uniform<glm::mat4> modelUniform;
+	Uniform<glm::mat3> normalMatrixUniform;
+
+	const uint64_t materialMask = (uint64_t(1) << RENDER_KEY_MATERIAL_BITS) - 1;
+	for (size_t i = 0; i < entries.size();) {
+		const auto &entry = entries[i];
+		const auto &item = items[entry.item];
+		if (filter && !filter(*item.shader)) {
+			i++;
+			continue;
+		}
+		const auto &mesh = *item.mesh;
+		auto itemMaterial = (entry.key >> (RENDER_KEY_VAO_BITS + RENDER_KEY_DEPTH_BITS)) & materialMask;
+
+		if (item.program != program) {
+			program = item.program;
+			program->use();
+			modelUniform = item.instanced ? Uniform<glm::mat4>() : program->uniform<glm::mat4>(MODEL_UNIFORM);
+			normalMatrixUniform = program->tryUniform<glm::mat3>(NORMAL_MATRIX_UNIFORM);
+			stats.programSwitches++;
+			// Sampler uniforms belong to the program, so they are set even if textures stay bound.
+			stats.textureSwitches += mesh.bindTextures(*program);
+			material = itemMaterial;
+		} else if (itemMaterial != material) {
+			stats.textureSwitches += mesh.bindTextures(*program);
+			material = itemMaterial;
+		}
+
+		if (mesh.getVAO() != vao) {
+			vao = mesh.getVAO();
+			state.bindVertexArray(vao);
+			stats.vaoSwitches++;
+		}
+
+		if (item.instanced) {
+			auto end = i + 1;
+			while (end < entries.size() && items[entries[end].item].mesh == item.mesh && items[entries[end].item].program == program) end++;
+			auto count = end - i;
+
+			glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer.id);
+			bindInstances(nInstanced);
+			glDrawElementsInstanced(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0, count);
+			unbindInstances();
+			nInstanced += count;
+			stats.instances += count;
+			i = end;
+		} else {
+			modelUniform.set(item.modelMatrix);
+			normalMatrixUniform.set(item.normalMatrix);
+			glDrawElements(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0);
+			stats.instances++;
+			i++;
+		}
+		stats.draws++;
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class GLState;
+class Mesh;
+class Model;
+class ShaderProgram;
+
+// Most significant first: program, material, VAO, then depth.
+const unsigned int RENDER_KEY_PROGRAM_BITS = 12;
+const unsigned int RENDER_KEY_MATERIAL_BITS = 16;
+const unsigned int RENDER_KEY_VAO_BITS = 16;
+const unsigned int RENDER_KEY_DEPTH_BITS = 20;
+const size_t RENDER_INSTANCING_THRESHOLD = 2;
+const GLuint RENDER_INSTANCE_MODEL_LOCATION = 3;
+const GLuint RENDER_INSTANCE_NORMAL_LOCATION = 7;
+
+struct RenderStats {
+	size_t draws;
+	size_t instances;
+	size_t programSwitches;
+	size_t textureSwitches;
+	size_t vaoSwitches;
+};
+
+class RenderQueue {
+	private:
+		struct Item {
+			const Mesh *mesh;
+			const ShaderProgram *shader;
+			glm::mat4 modelMatrix;
+			glm::mat3 normalMatrix;
+			float depth;
+			// The instanced variant of `shader` when the item is instanced.
+			const ShaderProgram *program;
+			bool instanced;
+		};
+
+		struct SortEntry {
+			uint64_t key;
+			uint32_t item;
+		};
+
+		struct Instance {
+			glm::mat4 modelMatrix;
+			glm::mat3 normalMatrix;
+		};
+
+		struct InstanceBuffer {
+			GLuint id = 0;
+
+			InstanceBuffer() = default;
+			InstanceBuffer(InstanceBuffer &&other) noexcept : id(std::exchange(other.id, 0)) {};
+			InstanceBuffer &operator=(InstanceBuffer &&other) noexcept { std::swap(id, other.id); return *this; };
+			~InstanceBuffer() { if (id) glDeleteBuffers(1, &id); };
+		};
+
+		struct GroupHash {
+			size_t operator()(const std::pair<const ShaderProgram *, const Mesh *> &group) const {
+				return std::hash<const void *>()(group.first) * 31 + std::hash<const void *>()(group.second);
+			};
+		};
+
+		std::vector<Item> items {};
+		std::vector<SortEntry> entries {};
+		std::vector<SortEntry> scratch {};
+		std::vector<Instance> instances {};
+		std::unordered_map<const ShaderProgram *, uint32_t> programs {};
+		std::map<std::vector<GLuint>, uint32_t> materials {};
+		std::unordered_map<GLuint, uint32_t> vaos {};
+		std::unordered_map<std::pair<const ShaderProgram *, const Mesh *>, size_t, GroupHash> groupSizes {};
+		std::unordered_map<const ShaderProgram *, const ShaderProgram *> instancedVariants {};
+		std::unordered_map<const ShaderProgram *, const ShaderProgram *> substitutes {};
+		InstanceBuffer instanceBuffer {};
+		float farPlane;
+		RenderStats stats {};
+
+		uint64_t makeKey(const Mesh &mesh, const ShaderProgram &shader, float depth);
+		void bindInstances(size_t first);
+		void unbindInstances();
+
+	public:
+		RenderQueue(float farPlane = 100.0f) : farPlane(farPlane) {};
+
+		// `instanced` reads `model` and `normalMatrix` from per-instance attributes.
+		void setInstancedVariant(const ShaderProgram &shader, const ShaderProgram &instanced);
+		// Draws pushed with `shader` are queued with `substitute` instead.
+		void setSubstitute(const ShaderProgram &shader, const ShaderProgram &substitute);
+
+		void clear();
+		void push(const Model &model, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix, const glm::mat4 &view);
+		void push(const Mesh &mesh, const ShaderProgram &shader, const glm::mat4 &modelMatrix, const glm::mat3 &normalMatrix, const glm::mat4 &view);
+		void sort();
+		// `filter` selects draws by queued program, so one sorted queue can feed several passes.
+		void submit(GLState &state, const std::function<bool(const ShaderProgram &)> &filter = nullptr);
+
+		size_t size() const { return items.size(); };
+		const RenderStats &getStats() const { return stats; };
+};
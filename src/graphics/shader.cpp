@@ -1,10 +1,14 @@
 #include "shader.hpp"
 
+#include "../util/hash.hpp"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #define INFO_LOG_LENGTH 512
 
@@ -31,6 +35,25 @@ std::string read_file(const std::string &path) {
 	return buf.str();
 }
 
+// Expands `#include "file"` lines, relative to the including file.
+std::string read_shader_source(const std::string &path) {
+	const std::string directive = "#include \"";
+	auto directory = path.substr(0, path.find_last_of('/') + 1);
+
+	std::istringstream source(read_file(path));
+	std::ostringstream expanded;
+	std::string line;
+	while (std::getline(source, line)) {
+		auto end = line.rfind('"');
+		if (line.compare(0, directive.size(), directive) == 0 && end >= directive.size()) {
+			expanded << read_shader_source(directory + line.substr(directive.size(), end - directive.size()));
+		} else {
+			expanded << line << '\n';
+		}
+	}
+	return expanded.str();
+}
+
 class Shader {
 	private:
 		GLuint id;
@@ -38,7 +61,7 @@ class Shader {
 
 	public:
 		Shader(GLenum type, const std::string &sourcePath) : type(type) {
-			auto source = read_file(sourcePath);
+			auto source = read_shader_source(sourcePath);
 			auto sourceStr = source.c_str();
 
 			id = glCreateShader(type);
@@ -62,7 +85,7 @@ class Shader {
 		void attach(GLuint program) { glAttachShader(program, id); };
 };
 
-ShaderProgram::ShaderProgram(const std::string &vertexSourcePath, const std::string &fragmentSourcePath) {
+ShaderProgram::ShaderProgram(GLState &state, const std::string &vertexSourcePath, const std::string &fragmentSourcePath) : state(&state) {
 	Shader vertexShader(GL_VERTEX_SHADER, vertexSourcePath);
 	Shader fragmentShader(GL_FRAGMENT_SHADER, fragmentSourcePath);
 
@@ -80,4 +103,44 @@ ShaderProgram::ShaderProgram(const std::string &vertexSourcePath, const std::str
 		what << "Error linking shader program: " << infoLog;
 		throw std::runtime_error(what.str());
 	}
+
+	reflectUniforms();
+}
+
+void ShaderProgram::reflectUniforms() {
+	GLint count = 0;
+	GLint maxLength = 0;
+	glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	std::vector<GLchar> name(std::max(maxLength, 1));
+	for (GLint i = 0; i < count; i++) {
+		GLsizei length;
+		GLint size;
+		GLenum type;
+		glGetActiveUniform(id, i, name.size(), &length, &size, &type, name.data());
+
+		GLint location = glGetUniformLocation(id, name.data());
+		if (location == -1) continue;
+
+		uniforms.push_back({ hashString(name.data(), length), location, type });
+		// Arrays are reported once as `name[0]` but may be set by their bare name.
+		if (length > 3 && std::string(name.data() + length - 3, 3) == "[0]") {
+			std::string base(name.data(), length - 3);
+			uniforms.push_back({ hashString(base.data(), base.size()), location, type });
+			for (GLint element = 1; element < size; element++) {
+				auto elementName = base + "[" + std::to_string(element) + "]";
+				uniforms.push_back({ hashString(elementName.data(), elementName.size()), glGetUniformLocation(id, elementName.c_str()), type });
+			}
+		}
+	}
+
+	std::sort(uniforms.begin(), uniforms.end(), [](const UniformInfo &a, const UniformInfo &b) { return a.hash < b.hash; });
+	auto collision = std::adjacent_find(uniforms.begin(), uniforms.end(), [](const UniformInfo &a, const UniformInfo &b) { return a.hash == b.hash; });
+	if (collision != uniforms.end()) throw std::logic_error("Two uniform names in shader program share a hash.");
+}
+
+const ShaderProgram::UniformInfo *ShaderProgram::find(uint32_t hash) const {
+	auto it = std::lower_bound(uniforms.begin(), uniforms.end(), hash, [](const UniformInfo &info, uint32_t hash) { return info.hash < hash; });
+	return it != uniforms.end() && it->hash == hash ? &*it : nullptr;
 }
\ No newline at end of file
@@ -1,32 +1,138 @@
 #pragma once
 
+#include "../ecs/types.hpp"
+#include "../util/hash.hpp"
+#include "gl_state.hpp"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstdint>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+struct UniformName {
+	uint32_t hash;
+	const char *name;
+
+	constexpr UniformName(const char *name) : hash(hashString(name)), name(name) {};
+	constexpr explicit UniformName(uint32_t hash) : hash(hash), name(nullptr) {};
+};
+
+inline void uploadUniform(GLint location, bool value) { glUniform1i(location, value); }
+inline void uploadUniform(GLint location, int value) { glUniform1i(location, value); }
+inline void uploadUniform(GLint location, float value) { glUniform1f(location, value); }
+inline void uploadUniform(GLint location, const glm::vec2 &value) { glUniform2fv(location, 1, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::vec3 &value) { glUniform3fv(location, 1, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::vec4 &value) { glUniform4fv(location, 1, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::mat2 &value) { glUniformMatrix2fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::mat3 &value) { glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+inline void uploadUniform(GLint location, const glm::mat4 &value) { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)); }
+
+template <typename T>
+bool uniformAccepts(GLenum type) {
+	if constexpr (std::is_same_v<T, bool>) return type == GL_BOOL;
+	else if constexpr (std::is_same_v<T, int>) {
+		switch (type) {
+			case GL_INT:
+			case GL_BOOL:
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_BUFFER:
+			case GL_INT_SAMPLER_BUFFER:
+			case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+				return true;
+			default:
+				return false;
+		}
+	}
+	else if constexpr (std::is_same_v<T, float>) return type == GL_FLOAT;
+	else if constexpr (std::is_same_v<T, glm::vec2>) return type == GL_FLOAT_VEC2;
+	else if constexpr (std::is_same_v<T, glm::vec3>) return type == GL_FLOAT_VEC3;
+	else if constexpr (std::is_same_v<T, glm::vec4>) return type == GL_FLOAT_VEC4;
+	else if constexpr (std::is_same_v<T, glm::mat2>) return type == GL_FLOAT_MAT2;
+	else if constexpr (std::is_same_v<T, glm::mat3>) return type == GL_FLOAT_MAT3;
+	else if constexpr (std::is_same_v<T, glm::mat4>) return type == GL_FLOAT_MAT4;
+	else static_assert(!std::is_same_v<T, T>, "Unsupported uniform type.");
+}
+
+// A missing uniform has location -1, which GL ignores.
+template <typename T>
+class Uniform {
+	private:
+		GLint location = -1;
+
+	public:
+		Uniform() = default;
+		explicit Uniform(GLint location) : location(location) {};
+
+		bool isValid() const { return location != -1; };
+		void set(const T &value) const { uploadUniform(location, value); };
+};
 
 class ShaderProgram {
 	private:
+		struct UniformInfo {
+			uint32_t hash;
+			GLint location;
+			GLenum type;
+		};
+
 		GLuint id;
-		GLint location(const std::string &name) const {
-			GLint res = glGetUniformLocation(id, name.c_str());
-			if (res == -1) {
+		GLState *state;
+		std::vector<UniformInfo> uniforms {};
+
+		void reflectUniforms();
+		const UniformInfo *find(uint32_t hash) const;
+		const UniformInfo &get(const UniformName &name) const {
+			auto *info = find(name.hash);
+			if (!info) {
 				std::ostringstream what;
-				what << "No uniform with name `" << name << "` in shader.";
+				what << "No uniform with name `" << (name.name ? name.name : "?") << "` in shader.";
 				throw std::runtime_error(what.str());
 			}
-			return res;
+			return *info;
+		};
+		GLint location(const std::string &name) const {
+			return get(UniformName(name.c_str())).location;
 		};
 		GLint tryLocation(const std::string &name) const {
-			return glGetUniformLocation(id, name.c_str());
+			auto *info = find(hashString(name.c_str(), name.size()));
+			return info ? info->location : -1;
 		};
 
 	public:
-		ShaderProgram(const std::string &vertexSourcePath, const std::string &fragmentSourcePath);
+		ShaderProgram(GLState &state, const std::string &vertexSourcePath, const std::string &fragmentSourcePath);
 		~ShaderProgram() { glDeleteProgram(id); };
-		void use() const { glUseProgram(id); };
+		void use() const { state->useProgram(id); };
+		void bindUniformBlock(const std::string &name, GLuint binding) const {
+			auto index = glGetUniformBlockIndex(id, name.c_str());
+			if (index != GL_INVALID_INDEX) glUniformBlockBinding(id, index, binding);
+		};
 
+		// Throws if the program has no such uniform or its type differs from `T`.
+		template <typename T>
+		Uniform<T> uniform(const UniformName &name) const {
+			const auto &info = get(name);
+			if (!uniformAccepts<T>(info.type)) {
+				std::ostringstream what;
+				what << "Uniform `" << (name.name ? name.name : "?") << "` has a different type in shader.";
+				throw std::runtime_error(what.str());
+			}
+			return Uniform<T>(info.location);
+		};
+		template <typename T>
+		Uniform<T> tryUniform(const UniformName &name) const {
+			auto *info = find(name.hash);
+			return info && uniformAccepts<T>(info->type) ? Uniform<T>(info->location) : Uniform<T>();
+		};
+
+		// These hash the name on every call; per-frame code should hold a handle.
 		void uniformBool(const std::string &name, bool value) const { use(); glUniform1i(location(name), value); };
 		void tryUniformBool(const std::string &name, bool value) const { use(); glUniform1i(tryLocation(name), value); };
 		void uniformInt(const std::string &name, int value) const { use(); glUniform1i(location(name), value); };
@@ -61,4 +167,7 @@ class ShaderProgram {
 		void tryUniformMat3(const std::string &name, const glm::mat3 &value) const { use(); glUniformMatrix3fv(tryLocation(name), 1, GL_FALSE, glm::value_ptr(value)); };
 		void uniformMat4(const std::string &name, const glm::mat4 &value) const { use(); glUniformMatrix4fv(location(name), 1, GL_FALSE, glm::value_ptr(value)); };
 		void tryUniformMat4(const std::string &name, const glm::mat4 &value) const { use(); glUniformMatrix4fv(tryLocation(name), 1, GL_FALSE, glm::value_ptr(value)); };
-};
\ No newline at end of file
+};
+
+template <>
+struct SharedComponent<ShaderProgram> : std::true_type {};
\ No newline at end of file
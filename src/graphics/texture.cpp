@@ -1,11 +1,12 @@
 #include "texture.hpp"
 
+#include "gl_state.hpp"
 #include <glad/glad.h>
 #include <stb_image/stb_image.h>
 #include <stdexcept>
 #include <sstream>
 
-Texture::Texture(const std::string &imagePath, TextureType type, GLint wrapS, GLint wrapT, GLint minFilter, GLint magFilter) :
+Texture::Texture(GLState &state, const std::string &imagePath, TextureType type, GLint wrapS, GLint wrapT, GLint minFilter, GLint magFilter) :
 	type(type)
 {
 	stbi_set_flip_vertically_on_load(true);
@@ -34,7 +35,7 @@ Texture::Texture(const std::string &imagePath, TextureType type, GLint wrapS, GL
 	}
 
 	glGenTextures(1, &id);
-	glBindTexture(GL_TEXTURE_2D, id);
+	state.bindTexture(0, id);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
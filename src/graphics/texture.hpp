@@ -1,5 +1,6 @@
 #pragma once
 
+#include "gl_state.hpp"
 #include <glad/glad.h>
 #include <iosfwd>
 
@@ -16,6 +17,7 @@ class Texture {
 
 	public:
 		Texture(
+			GLState &state,
 			const std::string &imagePath,
 			TextureType type,
 			GLint wrapS = GL_REPEAT,
@@ -24,10 +26,8 @@ class Texture {
 			GLint magFilter = GL_LINEAR
 		);
 
+		GLuint getId() const { return id; };
 		TextureType getType() const { return type; };
 
-		void use(GLenum number) const {
-			glActiveTexture(number);
-			glBindTexture(GL_TEXTURE_2D, id);
-		};
+		bool use(GLState &state, unsigned int unit) const { return state.bindTexture(unit, id); };
 };
\ No newline at end of file
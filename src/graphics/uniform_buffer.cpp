@@ -0,0 +1,21 @@
+#include "uniform_buffer.hpp"
+
+#include <stdexcept>
+#include <string>
+
+UniformBuffer::UniformBuffer(GLuint binding, size_t size) : binding(binding), size(size) {
+	glGenBuffers(1, &id);
+	glBindBuffer(GL_UNIFORM_BUFFER, id);
+	glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, id);
+}
+
+void UniformBuffer::update(const void *data, size_t size, size_t offset) {
+	if (offset + size > this->size)
+		throw std::length_error("Writing " + std::to_string(size) + " bytes at " + std::to_string(offset) + " overflows a " + std::to_string(this->size) + "-byte uniform buffer.");
+
+	glBindBuffer(GL_UNIFORM_BUFFER, id);
+	glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+
+class UniformBuffer {
+	private:
+		GLuint id;
+		GLuint binding;
+		size_t size;
+
+	public:
+		UniformBuffer(GLuint binding, size_t size);
+		UniformBuffer(const UniformBuffer &) = delete;
+		UniformBuffer &operator=(const UniformBuffer &) = delete;
+		~UniformBuffer() { glDeleteBuffers(1, &id); };
+
+		GLuint getBinding() const { return binding; };
+		void update(const void *data, size_t size, size_t offset = 0);
+		template <typename T>
+		void update(const T &data) { update(&data, sizeof(T)); };
+};
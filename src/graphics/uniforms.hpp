@@ -0,0 +1,70 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+
+// Must match `MAX_DIRECTIONAL_LIGHTS` in lighting.glsl.
+const int MAX_DIRECTIONAL_LIGHTS = 32;
+
+const GLuint UNIFORM_BINDING_CAMERA = 0;
+const GLuint UNIFORM_BINDING_LIGHTS = 1;
+const GLuint UNIFORM_BINDING_CLUSTERS = 2;
+
+const unsigned int TEXTURE_UNIT_CLUSTER_LIGHTS = 13;
+const unsigned int TEXTURE_UNIT_CLUSTER_GRID = 14;
+const unsigned int TEXTURE_UNIT_CLUSTER_INDICES = 15;
+
+// std140 mirrors of the shader blocks; vec3s take 16 bytes, hence the padding.
+struct CameraUniforms {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::mat4 inverseProjection;
+};
+
+struct LightPropertiesUniforms {
+	glm::vec3 ambient;
+	float padding0;
+	glm::vec3 diffuse;
+	float padding1;
+	glm::vec3 specular;
+	float padding2;
+};
+
+struct DirectionalLightUniforms {
+	glm::vec3 direction;
+	float padding;
+	LightPropertiesUniforms properties;
+};
+
+struct LightUniforms {
+	DirectionalLightUniforms directionalLights[MAX_DIRECTIONAL_LIGHTS];
+	GLint nDirectionalLights;
+};
+
+struct ClusterUniforms {
+	glm::ivec3 counts;
+	GLint padding;
+	glm::vec2 tileSize;
+	float depthScale;
+	float depthBias;
+};
+
+struct LocalLightTexels {
+	glm::vec3 position;
+	float range;
+	glm::vec3 direction;
+	float phi;
+	glm::vec3 ambient;
+	float gamma;
+	glm::vec3 diffuse;
+	float linear;
+	glm::vec3 specular;
+	float quadratic;
+};
+
+static_assert(sizeof(CameraUniforms) == 192);
+static_assert(sizeof(DirectionalLightUniforms) == 64);
+static_assert(offsetof(LightUniforms, nDirectionalLights) == MAX_DIRECTIONAL_LIGHTS * 64);
+static_assert(sizeof(ClusterUniforms) == 32);
+static_assert(sizeof(LocalLightTexels) == 5 * sizeof(glm::vec4));
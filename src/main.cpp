@@ -1,6 +1,16 @@
 #include "context.hpp"
 
-int main() {
-	Context ctx;
+#include <string>
+
+int main(int argc, char **argv) {
+	auto renderPath = FORWARD_SHADING;
+	std::string snapshotPath;
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--deferred") renderPath = DEFERRED_SHADING;
+		else if (arg == "--snapshot" && i + 1 < argc) snapshotPath = argv[++i];
+	}
+
+	Context ctx(renderPath, snapshotPath);
 	ctx.loop();
 }
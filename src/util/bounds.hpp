@@ -0,0 +1,76 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+struct AABB {
+	glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 max = glm::vec3(-std::numeric_limits<float>::max());
+
+	bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; };
+	glm::vec3 getCenter() const { return isEmpty() ? glm::vec3(0.0f) : (min + max) * 0.5f; };
+	glm::vec3 getExtents() const { return isEmpty() ? glm::vec3(0.0f) : (max - min) * 0.5f; };
+	float getSurfaceArea() const {
+		if (isEmpty()) return 0.0f;
+		auto size = max - min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	};
+
+	bool overlaps(const AABB &other) const {
+		return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::lessThanEqual(other.min, max));
+	};
+
+	bool overlaps(const glm::vec3 &center, float radius) const {
+		auto closest = glm::clamp(center, min, max);
+		auto offset = closest - center;
+		return glm::dot(offset, offset) <= radius * radius;
+	};
+
+	// Negative on a miss; `inverseDirection` is 1 / direction.
+	float intersectRay(const glm::vec3 &origin, const glm::vec3 &inverseDirection, float maxDistance) const {
+		auto t0 = (min - origin) * inverseDirection;
+		auto t1 = (max - origin) * inverseDirection;
+		auto entries = glm::min(t0, t1);
+		auto exits = glm::max(t0, t1);
+		float enter = std::max({ entries.x, entries.y, entries.z, 0.0f });
+		float leave = std::min({ exits.x, exits.y, exits.z, maxDistance });
+		return enter <= leave ? enter : -1.0f;
+	};
+
+	void add(const glm::vec3 &point) {
+		min = glm::min(min, point);
+		max = glm::max(max, point);
+	};
+
+	void add(const AABB &other) {
+		min = glm::min(min, other.min);
+		max = glm::max(max, other.max);
+	};
+
+	AABB transformed(const glm::mat4 &matrix) const {
+		auto center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+		auto extents = getExtents();
+		auto worldExtents =
+			glm::abs(glm::vec3(matrix[0])) * extents.x +
+			glm::abs(glm::vec3(matrix[1])) * extents.y +
+			glm::abs(glm::vec3(matrix[2])) * extents.z;
+		return { center - worldExtents, center + worldExtents };
+	};
+};
+
+struct BoundingSphere {
+	glm::vec3 center = glm::vec3(0.0f);
+	float radius = 0.0f;
+
+	// Scaling may be non-uniform, so the radius grows by the largest axis scale.
+	BoundingSphere transformed(const glm::mat4 &matrix) const {
+		float scale = std::max({
+			glm::length(glm::vec3(matrix[0])),
+			glm::length(glm::vec3(matrix[1])),
+			glm::length(glm::vec3(matrix[2])),
+		});
+		return { glm::vec3(matrix * glm::vec4(center, 1.0f)), radius * scale };
+	};
+};
@@ -0,0 +1,148 @@
+#include "bvh.hpp"
+
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+
+void BVH::build(std::vector<AABB> bounds, ThreadPool *pool) {
+	if (bounds.size() >= BVH_INVALID_INDEX) throw std::length_error("Too many primitives for a BVH.");
+
+	primitiveBounds = std::move(bounds);
+	primitives.resize(primitiveBounds.size());
+
+	nodes.clear();
+	leafOf.assign(primitives.size(), BVH_INVALID_INDEX);
+	if (primitives.empty()) return;
+
+	nodes.resize(2 * primitives.size() - 1);
+	nodes[0].begin = 0;
+	nodes[0].end = primitives.size();
+	nodes[0].parent = BVH_INVALID_INDEX;
+	std::vector<BuildReference> references(primitives.size());
+	for (uint32_t i = 0; i < references.size(); i++)
+		references[i] = { primitiveBounds[i], primitiveBounds[i].getCenter(), i };
+
+	std::atomic<uint32_t> nextNode = 1;
+	buildNode(0, references, nextNode, pool);
+	nodes.resize(nextNode);
+	for (uint32_t i = 0; i < references.size(); i++) primitives[i] = references[i].primitive;
+
+	for (uint32_t index = 0; index < nodes.size(); index++) {
+		const auto &node = nodes[index];
+		if (!isLeaf(node)) continue;
+		for (auto i = node.begin; i < node.end; i++) leafOf[primitives[i]] = index;
+	}
+}
+
+void BVH::buildNode(uint32_t index, std::vector<BuildReference> &references, std::atomic<uint32_t> &nextNode, ThreadPool *pool) {
+	auto &node = nodes[index];
+	node.left = BVH_INVALID_INDEX;
+	node.bounds = AABB();
+	AABB centroids;
+	for (auto i = node.begin; i < node.end; i++) {
+		node.bounds.add(references[i].bounds);
+		centroids.add(references[i].center);
+	}
+
+	size_t count = node.end - node.begin;
+	if (count == 1) return;
+
+	float bestCost = std::numeric_limits<float>::max();
+	int bestAxis = -1;
+	unsigned int bestBin = 0;
+	// Small nodes are about as numerous as primitives, so they get fewer bins.
+	auto nBins = static_cast<unsigned int>(std::min<size_t>(count, BVH_SAH_BINS));
+	auto centroidSize = centroids.max - centroids.min;
+	auto scale = glm::vec3(nBins) / glm::max(centroidSize, glm::vec3(std::numeric_limits<float>::min()));
+
+	std::array<std::array<AABB, BVH_SAH_BINS>, 3> binBounds {};
+	std::array<std::array<size_t, BVH_SAH_BINS>, 3> binCounts {};
+	for (auto i = node.begin; i < node.end; i++) {
+		const auto &reference = references[i];
+		auto bins = glm::min(glm::uvec3((reference.center - centroids.min) * scale), glm::uvec3(nBins - 1));
+		for (int axis = 0; axis < 3; axis++) {
+			binBounds[axis][bins[axis]].add(reference.bounds);
+			binCounts[axis][bins[axis]]++;
+		}
+	}
+
+	for (int axis = 0; axis < 3; axis++) {
+		if (centroidSize[axis] <= 0.0f) continue;
+
+		std::array<float, BVH_SAH_BINS> rightCosts {};
+		AABB right;
+		size_t rightCount = 0;
+		for (auto bin = nBins - 1; bin > 0; bin--) {
+			right.add(binBounds[axis][bin]);
+			rightCount += binCounts[axis][bin];
+			rightCosts[bin] = rightCount ? right.getSurfaceArea() * rightCount : -1.0f;
+		}
+
+		AABB left;
+		size_t leftCount = 0;
+		for (unsigned int bin = 1; bin < nBins; bin++) {
+			left.add(binBounds[axis][bin - 1]);
+			leftCount += binCounts[axis][bin - 1];
+			if (!leftCount || rightCosts[bin] < 0.0f) continue;
+			float cost = left.getSurfaceArea() * leftCount + rightCosts[bin];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = bin;
+			}
+		}
+	}
+
+	float area = node.bounds.getSurfaceArea();
+	float splitCost = area > 0.0f ? 1.0f + bestCost / area : 1.0f;
+	if (count <= BVH_MAX_LEAF_SIZE && (bestAxis == -1 || splitCost >= count)) return;
+
+	auto first = references.begin() + node.begin;
+	auto last = references.begin() + node.end;
+	uint32_t middle;
+	if (bestAxis == -1) {
+		// Every centroid is in the same place.
+		middle = node.begin + count / 2;
+	} else {
+		auto split = std::partition(first, last, [&](const BuildReference &reference) {
+			return std::min<unsigned int>((reference.center[bestAxis] - centroids.min[bestAxis]) * scale[bestAxis], nBins - 1) < bestBin;
+		});
+		middle = split - references.begin();
+	}
+
+	uint32_t left = nextNode.fetch_add(2);
+	node.left = left;
+	nodes[left] = { AABB(), node.begin, middle, BVH_INVALID_INDEX, index };
+	nodes[left + 1] = { AABB(), middle, node.end, BVH_INVALID_INDEX, index };
+
+	if (pool && pool->size() > 1 && count > BVH_PARALLEL_THRESHOLD) {
+		pool->parallelFor(2, [&](size_t child) { buildNode(left + child, references, nextNode, pool); });
+	} else {
+		buildNode(left + 1, references, nextNode, pool);
+		buildNode(left, references, nextNode, pool);
+	}
+}
+
+void BVH::update(uint32_t primitive, const AABB &bounds) {
+	if (primitive >= primitiveBounds.size())
+		throw std::out_of_range("Primitive " + std::to_string(primitive) + " is not in the BVH.");
+	primitiveBounds[primitive] = bounds;
+
+	for (auto index = leafOf[primitive]; index != BVH_INVALID_INDEX;) {
+		auto &node = nodes[index];
+		AABB refitted;
+		if (isLeaf(node)) {
+			for (auto i = node.begin; i < node.end; i++) refitted.add(primitiveBounds[primitives[i]]);
+		} else {
+			refitted.add(nodes[node.left].bounds);
+			refitted.add(nodes[node.left + 1].bounds);
+		}
+
+		// Ancestors already enclose an unchanged node.
+		if (refitted.min == node.bounds.min && refitted.max == node.bounds.max) break;
+		node.bounds = refitted;
+		index = node.parent;
+	}
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "bounds.hpp"
+#include "frustum.hpp"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+class ThreadPool;
+
+const uint32_t BVH_INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+const size_t BVH_MAX_LEAF_SIZE = 4;
+const unsigned int BVH_SAH_BINS = 16;
+const size_t BVH_PARALLEL_THRESHOLD = 16384;
+
+class BVH {
+	private:
+		struct Node {
+			AABB bounds;
+			uint32_t begin;
+			uint32_t end;
+			// Children are `left` and `left + 1`.
+			uint32_t left;
+			uint32_t parent;
+		};
+
+		std::vector<Node> nodes {};
+		std::vector<AABB> primitiveBounds {};
+		std::vector<uint32_t> primitives {};
+		std::vector<uint32_t> leafOf {};
+
+		struct BuildReference {
+			AABB bounds;
+			glm::vec3 center;
+			uint32_t primitive;
+		};
+
+		bool isLeaf(const Node &node) const { return node.left == BVH_INVALID_INDEX; };
+		void buildNode(uint32_t index, std::vector<BuildReference> &references, std::atomic<uint32_t> &nextNode, ThreadPool *pool);
+
+		template <typename Test, typename F>
+		void traverse(Test &&test, F &&fn) const {
+			if (nodes.empty()) return;
+			std::vector<uint32_t> stack { 0 };
+			while (!stack.empty()) {
+				const auto &node = nodes[stack.back()];
+				stack.pop_back();
+				if (!test(node.bounds)) continue;
+				if (isLeaf(node)) {
+					for (auto i = node.begin; i < node.end; i++) {
+						auto primitive = primitives[i];
+						if (test(primitiveBounds[primitive])) fn(primitive);
+					}
+				} else {
+					stack.push_back(node.left + 1);
+					stack.push_back(node.left);
+				}
+			}
+		};
+
+	public:
+		void build(std::vector<AABB> bounds, ThreadPool *pool = nullptr);
+		// Refits without rebuilding, so queries slow down as primitives drift.
+		void update(uint32_t primitive, const AABB &bounds);
+
+		size_t size() const { return primitiveBounds.size(); };
+		const AABB &getBounds(uint32_t primitive) const { return primitiveBounds[primitive]; };
+
+		// `inside` is whether the primitive is entirely inside `frustum`.
+		template <typename F>
+		void queryFrustum(const Frustum &frustum, F &&fn) const {
+			if (nodes.empty()) return;
+			std::vector<std::pair<uint32_t, unsigned int>> stack { { 0, FRUSTUM_ALL_PLANES } };
+			while (!stack.empty()) {
+				auto [index, planeMask] = stack.back();
+				stack.pop_back();
+				const auto &node = nodes[index];
+
+				auto containment = frustum.test(node.bounds, planeMask);
+				if (containment == OUTSIDE) continue;
+				if (containment == INSIDE) {
+					for (auto i = node.begin; i < node.end; i++) fn(primitives[i], true);
+				} else if (isLeaf(node)) {
+					for (auto i = node.begin; i < node.end; i++) {
+						auto primitiveMask = planeMask;
+						auto primitiveContainment = frustum.test(primitiveBounds[primitives[i]], primitiveMask);
+						if (primitiveContainment != OUTSIDE) fn(primitives[i], primitiveContainment == INSIDE);
+					}
+				} else {
+					stack.push_back({ node.left + 1, planeMask });
+					stack.push_back({ node.left, planeMask });
+				}
+			}
+		};
+
+		template <typename F>
+		void queryAABB(const AABB &box, F &&fn) const {
+			traverse([&](const AABB &bounds) { return bounds.overlaps(box); }, fn);
+		};
+
+		template <typename F>
+		void querySphere(const BoundingSphere &sphere, F &&fn) const {
+			traverse([&](const AABB &bounds) { return bounds.overlaps(sphere.center, sphere.radius); }, fn);
+		};
+
+		// `distance` is where the ray enters the box, in units of `direction`.
+		template <typename F>
+		void queryRay(const glm::vec3 &origin, const glm::vec3 &direction, float maxDistance, F &&fn) const {
+			auto inverseDirection = 1.0f / direction;
+			float distance = 0.0f;
+			traverse(
+				[&](const AABB &bounds) {
+					distance = bounds.intersectRay(origin, inverseDirection, maxDistance);
+					return distance >= 0.0f;
+				},
+				[&](uint32_t primitive) { fn(primitive, distance); }
+			);
+		};
+};
@@ -19,4 +19,11 @@ class Cache {
 			if (it == cache.end()) return std::nullopt;
 			return std::optional<std::shared_ptr<V>>(it->second);
 		};
+
+		std::optional<K> keyOf(const V *value) const {
+			for (const auto &[key, cached] : cache) {
+				if (cached.get() == value) return std::optional<K>(key);
+			}
+			return std::nullopt;
+		};
 };
\ No newline at end of file
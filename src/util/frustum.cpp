@@ -0,0 +1,107 @@
+#include "frustum.hpp"
+
+#include "simd.hpp"
+#include <cmath>
+#include <limits>
+
+Frustum::Frustum(const glm::mat4 &viewProjection) {
+	auto row = [&](int i) { return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]); };
+	// Left, right, bottom, top, near, far.
+	planes[0] = row(3) + row(0);
+	planes[1] = row(3) - row(0);
+	planes[2] = row(3) + row(1);
+	planes[3] = row(3) - row(1);
+	planes[4] = row(3) + row(2);
+	planes[5] = row(3) - row(2);
+	for (auto &plane : planes) plane /= glm::length(glm::vec3(plane));
+}
+
+Containment Frustum::test(const AABB &box, unsigned int &planeMask) const {
+	auto center = box.getCenter();
+	auto extents = box.getExtents();
+	for (unsigned int i = 0; i < 6; i++) {
+		if (!(planeMask & (1 << i))) continue;
+		const auto &plane = planes[i];
+		float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+		float radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+		if (distance + radius < 0.0f) return OUTSIDE;
+		if (distance - radius >= 0.0f) planeMask &= ~(1 << i);
+	}
+	return planeMask ? INTERSECTING : INSIDE;
+}
+
+void BoundsBatch::clear() {
+	centerX.clear();
+	centerY.clear();
+	centerZ.clear();
+	extentX.clear();
+	extentY.clear();
+	extentZ.clear();
+	radius.clear();
+}
+
+void BoundsBatch::push(const AABB &box, const BoundingSphere &sphere) {
+	auto center = box.getCenter();
+	auto extents = box.getExtents();
+	centerX.push_back(center.x);
+	centerY.push_back(center.y);
+	centerZ.push_back(center.z);
+	extentX.push_back(extents.x);
+	extentY.push_back(extents.y);
+	extentZ.push_back(extents.z);
+	radius.push_back(sphere.radius);
+}
+
+BoundsArrays BoundsBatch::getArrays() const {
+	return {
+		.centerX = centerX.data(),
+		.centerY = centerY.data(),
+		.centerZ = centerZ.data(),
+		.extentX = extentX.data(),
+		.extentY = extentY.data(),
+		.extentZ = extentZ.data(),
+		.radius = radius.data(),
+		.count = radius.size(),
+	};
+}
+
+// Negative when the volume is outside some plane.
+template <typename V>
+void cullLanes(const Frustum &frustum, const BoundsArrays &bounds, size_t i, unsigned char *visible) {
+	using L = simd::Lane<V>;
+	auto centerX = L::load(bounds.centerX + i);
+	auto centerY = L::load(bounds.centerY + i);
+	auto centerZ = L::load(bounds.centerZ + i);
+	auto extentX = L::load(bounds.extentX + i);
+	auto extentY = L::load(bounds.extentY + i);
+	auto extentZ = L::load(bounds.extentZ + i);
+	auto radius = L::load(bounds.radius + i);
+
+	auto distance = L::set(std::numeric_limits<float>::max());
+	for (const auto &plane : frustum.planes) {
+		auto center = simd::add(
+			simd::add(simd::mul(L::set(plane.x), centerX), simd::mul(L::set(plane.y), centerY)),
+			simd::add(simd::mul(L::set(plane.z), centerZ), L::set(plane.w))
+		);
+		auto boxRadius = simd::add(
+			simd::add(simd::mul(L::set(std::fabs(plane.x)), extentX), simd::mul(L::set(std::fabs(plane.y)), extentY)),
+			simd::mul(L::set(std::fabs(plane.z)), extentZ)
+		);
+		distance = simd::minimum(distance, simd::add(center, simd::minimum(boxRadius, radius)));
+	}
+
+	float distances[L::width];
+	L::store(distances, distance);
+	for (int lane = 0; lane < L::width; lane++) visible[i + lane] = distances[lane] >= 0.0f;
+}
+
+void cullBounds(const Frustum &frustum, const BoundsArrays &bounds, unsigned char *visible) {
+	size_t i = 0;
+	#ifdef SIMD_LANES_AVX2
+		for (; i + 8 <= bounds.count; i += 8) cullLanes<simd::Float8>(frustum, bounds, i, visible);
+	#endif
+	#ifdef SIMD_LANES_SSE2
+		for (; i + 4 <= bounds.count; i += 4) cullLanes<simd::Float4>(frustum, bounds, i, visible);
+	#endif
+	for (; i < bounds.count; i++) cullLanes<float>(frustum, bounds, i, visible);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "bounds.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+enum Containment {
+	OUTSIDE,
+	INTERSECTING,
+	INSIDE,
+};
+
+const unsigned int FRUSTUM_ALL_PLANES = (1 << 6) - 1;
+
+// Unit normals point inwards: p is inside a plane when dot(normal, p) + distance >= 0.
+struct Frustum {
+	glm::vec4 planes[6];
+
+	Frustum(const glm::mat4 &viewProjection);
+
+	// Clears the bits of planes `box` is entirely inside, so its children skip them.
+	Containment test(const AABB &box, unsigned int &planeMask) const;
+};
+
+// Each box and its sphere share a center.
+struct BoundsArrays {
+	const float *centerX;
+	const float *centerY;
+	const float *centerZ;
+	const float *extentX;
+	const float *extentY;
+	const float *extentZ;
+	const float *radius;
+	size_t count;
+};
+
+class BoundsBatch {
+	private:
+		std::vector<float> centerX {}, centerY {}, centerZ {};
+		std::vector<float> extentX {}, extentY {}, extentZ {};
+		std::vector<float> radius {};
+
+	public:
+		void clear();
+		// `sphere` only contributes its radius.
+		void push(const AABB &box, const BoundingSphere &sphere);
+		size_t size() const { return radius.size(); };
+		BoundsArrays getArrays() const;
+};
+
+void cullBounds(const Frustum &frustum, const BoundsArrays &bounds, unsigned char *visible);
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// 32-bit FNV-1a.
+constexpr uint32_t hashString(const char *str, size_t length) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= static_cast<unsigned char>(str[i]);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+constexpr uint32_t hashString(const char *str) {
+	size_t length = 0;
+	while (str[length]) length++;
+	return hashString(str, length);
+}
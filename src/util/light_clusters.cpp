@@ -0,0 +1,154 @@
+#include "light_clusters.hpp"
+
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <initializer_list>
+
+void SphereSet::clear() {
+	x.clear();
+	y.clear();
+	z.clear();
+	radiusSquared.clear();
+	ids.clear();
+}
+
+void SphereSet::push(float x, float y, float z, float radiusSquared, uint32_t id) {
+	this->x.push_back(x);
+	this->y.push_back(y);
+	this->z.push_back(z);
+	this->radiusSquared.push_back(radiusSquared);
+	ids.push_back(id);
+}
+
+template <typename V, typename Emit>
+void overlapLanes(const SphereSet &spheres, size_t i, const AABB &box, Emit &emit) {
+	using L = simd::Lane<V>;
+	auto zero = L::set(0.0f);
+	auto axis = [&](const std::vector<float> &centers, float lower, float upper) {
+		auto center = L::load(centers.data() + i);
+		auto distance = simd::maximum(simd::maximum(simd::sub(L::set(lower), center), simd::sub(center, L::set(upper))), zero);
+		return simd::mul(distance, distance);
+	};
+	auto distance = simd::add(simd::add(axis(spheres.x, box.min.x, box.max.x), axis(spheres.y, box.min.y, box.max.y)), axis(spheres.z, box.min.z, box.max.z));
+
+	float separations[L::width];
+	L::store(separations, simd::sub(distance, L::load(spheres.radiusSquared.data() + i)));
+	for (int lane = 0; lane < L::width; lane++) {
+		if (separations[lane] <= 0.0f) emit(i + lane);
+	}
+}
+
+template <typename Emit>
+void forEachOverlap(const SphereSet &spheres, const AABB &box, Emit emit) {
+	size_t i = 0;
+	#ifdef SIMD_LANES_AVX2
+		for (; i + 8 <= spheres.size(); i += 8) overlapLanes<simd::Float8>(spheres, i, box, emit);
+	#endif
+	#ifdef SIMD_LANES_SSE2
+		for (; i + 4 <= spheres.size(); i += 4) overlapLanes<simd::Float4>(spheres, i, box, emit);
+	#endif
+	for (; i < spheres.size(); i++) overlapLanes<float>(spheres, i, box, emit);
+}
+
+void filterSpheres(const SphereSet &spheres, const AABB &box, SphereSet &overlapping) {
+	overlapping.clear();
+	forEachOverlap(spheres, box, [&](size_t i) {
+		overlapping.push(spheres.x[i], spheres.y[i], spheres.z[i], spheres.radiusSquared[i], spheres.ids[i]);
+	});
+}
+
+LightClusters::LightClusters(ThreadPool *pool) :
+	sliceBounds(CLUSTERS_Z),
+	rowBounds(CLUSTERS_Y * CLUSTERS_Z),
+	clusterBounds(CLUSTER_COUNT),
+	slices(CLUSTERS_Z),
+	grid(CLUSTER_COUNT, glm::uvec2(0)),
+	pool(pool)
+{}
+
+glm::vec2 LightClusters::getTileSize() const {
+	return glm::ceil(glm::vec2(screen) / glm::vec2(CLUSTERS_X, CLUSTERS_Y));
+}
+
+void LightClusters::setProjection(const glm::mat4 &projection, unsigned int width, unsigned int height) {
+	glm::uvec2 size(width, height);
+	if (projection == this->projection && size == screen) return;
+	this->projection = projection;
+	screen = size;
+
+	// A perspective projection has clip z = m22 * z + m32 and w = -z.
+	float near = projection[3][2] / (projection[2][2] - 1.0f);
+	float far = projection[3][2] / (projection[2][2] + 1.0f);
+	depthScale = CLUSTERS_Z / std::log(far / near);
+	depthBias = -std::log(near) * depthScale;
+
+	auto inverseProjection = glm::inverse(projection);
+	auto ray = [&](glm::vec2 window) {
+		auto ndc = glm::min(window / glm::vec2(size), 1.0f) * 2.0f - 1.0f;
+		auto point = inverseProjection * glm::vec4(ndc, -1.0f, 1.0f);
+		auto view = glm::vec3(point) / point.w;
+		return view / -view.z;
+	};
+	auto segment = [&](glm::vec2 lower, glm::vec2 upper, int z) {
+		float nearDepth = near * std::pow(far / near, static_cast<float>(z) / CLUSTERS_Z);
+		float farDepth = near * std::pow(far / near, static_cast<float>(z + 1) / CLUSTERS_Z);
+		AABB box;
+		for (auto corner : { lower, glm::vec2(upper.x, lower.y), glm::vec2(lower.x, upper.y), upper }) {
+			auto direction = ray(corner);
+			box.add(direction * nearDepth);
+			box.add(direction * farDepth);
+		}
+		return box;
+	};
+
+	auto tile = getTileSize();
+	for (int z = 0; z < CLUSTERS_Z; z++) {
+		sliceBounds[z] = segment(glm::vec2(0.0f), glm::vec2(size), z);
+		for (int y = 0; y < CLUSTERS_Y; y++) {
+			rowBounds[y + CLUSTERS_Y * z] = segment(glm::vec2(0.0f, y * tile.y), glm::vec2(size.x, (y + 1) * tile.y), z);
+			for (int x = 0; x < CLUSTERS_X; x++)
+				clusterBounds[x + CLUSTERS_X * (y + CLUSTERS_Y * z)] = segment(glm::vec2(x, y) * tile, glm::vec2(x + 1, y + 1) * tile, z);
+		}
+	}
+}
+
+void LightClusters::assignSlice(int z) {
+	auto &slice = slices[z];
+	slice.indices.clear();
+	filterSpheres(spheres, sliceBounds[z], slice.lights);
+
+	for (int y = 0; y < CLUSTERS_Y; y++) {
+		filterSpheres(slice.lights, rowBounds[y + CLUSTERS_Y * z], slice.row);
+		for (int x = 0; x < CLUSTERS_X; x++) {
+			auto cluster = x + CLUSTERS_X * (y + CLUSTERS_Y * z);
+			uint32_t offset = slice.indices.size();
+			forEachOverlap(slice.row, clusterBounds[cluster], [&](size_t i) { slice.indices.push_back(slice.row.ids[i]); });
+			// Offsets are relative to the slice until `assign` lays the slices out back to back.
+			grid[cluster] = glm::uvec2(offset, slice.indices.size() - offset);
+		}
+	}
+}
+
+void LightClusters::assign(const std::vector<glm::vec4> &lights) {
+	spheres.clear();
+	for (uint32_t i = 0; i < lights.size(); i++) {
+		const auto &light = lights[i];
+		spheres.push(light.x, light.y, light.z, light.w * light.w, i);
+	}
+
+	if (pool) {
+		pool->parallelFor(CLUSTERS_Z, [this](size_t z) { assignSlice(z); });
+	} else {
+		for (int z = 0; z < CLUSTERS_Z; z++) assignSlice(z);
+	}
+
+	indices.clear();
+	for (int z = 0; z < CLUSTERS_Z; z++) {
+		uint32_t base = indices.size();
+		auto first = grid.begin() + CLUSTERS_X * CLUSTERS_Y * z;
+		for (auto cluster = first; cluster != first + CLUSTERS_X * CLUSTERS_Y; cluster++) cluster->x += base;
+		indices.insert(indices.end(), slices[z].indices.begin(), slices[z].indices.end());
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "bounds.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+const int CLUSTERS_X = 16;
+const int CLUSTERS_Y = 9;
+const int CLUSTERS_Z = 24;
+const int CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+struct SphereSet {
+	std::vector<float> x {}, y {}, z {}, radiusSquared {};
+	std::vector<uint32_t> ids {};
+
+	void clear();
+	void push(float x, float y, float z, float radiusSquared, uint32_t id);
+	size_t size() const { return ids.size(); };
+};
+
+// Cluster (x, y, z) is grid entry x + CLUSTERS_X * (y + CLUSTERS_Y * z), an (offset, count) into `getIndices()`.
+class LightClusters {
+	private:
+		struct Slice {
+			SphereSet lights;
+			SphereSet row;
+			std::vector<uint32_t> indices;
+		};
+
+		glm::mat4 projection { 0.0f };
+		glm::uvec2 screen { 0 };
+		float depthScale = 0.0f;
+		float depthBias = 0.0f;
+		std::vector<AABB> sliceBounds;
+		std::vector<AABB> rowBounds;
+		std::vector<AABB> clusterBounds;
+
+		SphereSet spheres {};
+		std::vector<Slice> slices;
+		std::vector<glm::uvec2> grid;
+		std::vector<uint32_t> indices {};
+		ThreadPool *pool;
+
+		void assignSlice(int z);
+
+	public:
+		LightClusters(ThreadPool *pool = nullptr);
+
+		void setProjection(const glm::mat4 &projection, unsigned int width, unsigned int height);
+		// `lights` are view-space centers and radii.
+		void assign(const std::vector<glm::vec4> &lights);
+
+		const std::vector<glm::uvec2> &getGrid() const { return grid; };
+		const std::vector<uint32_t> &getIndices() const { return indices; };
+		glm::vec2 getTileSize() const;
+		// The slice at view depth d is floor(log(d) * depthScale + depthBias).
+		float getDepthScale() const { return depthScale; };
+		float getDepthBias() const { return depthBias; };
+};
@@ -0,0 +1,216 @@
+#include "occlusion.hpp"
+
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+const int TILE_SIZE = OCCLUSION_TILE_WIDTH * OCCLUSION_TILE_HEIGHT;
+const float LANE_OFFSETS[8] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f };
+
+OcclusionBuffer::OcclusionBuffer(ThreadPool *pool) :
+	bins(OCCLUSION_TILES_X * OCCLUSION_TILES_Y),
+	depths(OCCLUSION_WIDTH * OCCLUSION_HEIGHT, 1.0f),
+	tileMaxDepths(OCCLUSION_TILES_X * OCCLUSION_TILES_Y, 1.0f),
+	pool(pool)
+{}
+
+void OcclusionBuffer::clear() {
+	triangles.clear();
+	for (auto &bin : bins) bin.clear();
+	std::fill(depths.begin(), depths.end(), 1.0f);
+	std::fill(tileMaxDepths.begin(), tileMaxDepths.end(), 1.0f);
+}
+
+void OcclusionBuffer::addClipTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) {
+	// Only the near plane needs clipping; the screen bounds clamp everything else.
+	const glm::vec4 *vertices[3] = { &a, &b, &c };
+	glm::vec4 clipped[4];
+	int nClipped = 0;
+	for (int i = 0; i < 3; i++) {
+		const auto &from = *vertices[i];
+		const auto &to = *vertices[(i + 1) % 3];
+		float fromDistance = from.z + from.w;
+		float toDistance = to.z + to.w;
+		if (fromDistance >= 0.0f) clipped[nClipped++] = from;
+		if ((fromDistance >= 0.0f) != (toDistance >= 0.0f))
+			clipped[nClipped++] = from + (to - from) * (fromDistance / (fromDistance - toDistance));
+	}
+	for (int i = 2; i < nClipped; i++) addScreenTriangle(clipped[0], clipped[i - 1], clipped[i]);
+}
+
+void OcclusionBuffer::addScreenTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) {
+	glm::vec3 screen[3];
+	const glm::vec4 *vertices[3] = { &a, &b, &c };
+	for (int i = 0; i < 3; i++) {
+		const auto &clip = *vertices[i];
+		if (clip.w <= 0.0f) return;
+		auto ndc = glm::vec3(clip) / clip.w;
+		screen[i] = glm::vec3(
+			(ndc.x * 0.5f + 0.5f) * OCCLUSION_WIDTH,
+			(ndc.y * 0.5f + 0.5f) * OCCLUSION_HEIGHT,
+			ndc.z * 0.5f + 0.5f
+		);
+	}
+
+	auto area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) - (screen[1].y - screen[0].y) * (screen[2].x - screen[0].x);
+	if (area == 0.0f) return;
+	if (area < 0.0f) {
+		std::swap(screen[1], screen[2]);
+		area = -area;
+	}
+
+	Triangle triangle;
+	for (int i = 0; i < 3; i++) {
+		const auto &from = screen[i];
+		const auto &to = screen[(i + 1) % 3];
+		float edgeA = from.y - to.y;
+		float edgeB = to.x - from.x;
+		triangle.edges[i] = glm::vec3(edgeA, edgeB, -(edgeA * from.x + edgeB * from.y));
+	}
+
+	auto dz1 = screen[1].z - screen[0].z;
+	auto dz2 = screen[2].z - screen[0].z;
+	auto dzdx = (dz1 * (screen[2].y - screen[0].y) - dz2 * (screen[1].y - screen[0].y)) / area;
+	auto dzdy = (dz2 * (screen[1].x - screen[0].x) - dz1 * (screen[2].x - screen[0].x)) / area;
+	triangle.depth = glm::vec3(dzdx, dzdy, screen[0].z - dzdx * screen[0].x - dzdy * screen[0].y);
+
+	auto lower = glm::min(glm::min(screen[0], screen[1]), screen[2]);
+	auto upper = glm::max(glm::max(screen[0], screen[1]), screen[2]);
+	triangle.minX = std::max(0, static_cast<int>(std::floor(lower.x)));
+	triangle.minY = std::max(0, static_cast<int>(std::floor(lower.y)));
+	triangle.maxX = std::min(OCCLUSION_WIDTH - 1, static_cast<int>(std::floor(upper.x)));
+	triangle.maxY = std::min(OCCLUSION_HEIGHT - 1, static_cast<int>(std::floor(upper.y)));
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) return;
+	if (lower.z > 1.0f) return;
+
+	uint32_t index = triangles.size();
+	triangles.push_back(triangle);
+	for (int tileY = triangle.minY / OCCLUSION_TILE_HEIGHT; tileY <= triangle.maxY / OCCLUSION_TILE_HEIGHT; tileY++) {
+		for (int tileX = triangle.minX / OCCLUSION_TILE_WIDTH; tileX <= triangle.maxX / OCCLUSION_TILE_WIDTH; tileX++)
+			bins[tileY * OCCLUSION_TILES_X + tileX].push_back(index);
+	}
+}
+
+// Tile rows are a whole number of lanes, so lanes never straddle tiles.
+template <typename V, typename Triangle>
+void rasterizeLanes(const Triangle &triangle, float *tile, int tileX, int tileY) {
+	using L = simd::Lane<V>;
+	int minX = std::max(triangle.minX, tileX);
+	int maxX = std::min(triangle.maxX, tileX + OCCLUSION_TILE_WIDTH - 1);
+	int minY = std::max(triangle.minY, tileY);
+	int maxY = std::min(triangle.maxY, tileY + OCCLUSION_TILE_HEIGHT - 1);
+	minX = tileX + (minX - tileX) / L::width * L::width;
+
+	auto offsets = L::load(LANE_OFFSETS);
+	auto zero = L::set(0.0f);
+	const auto &e0 = triangle.edges[0];
+	const auto &e1 = triangle.edges[1];
+	const auto &e2 = triangle.edges[2];
+	const auto &depth = triangle.depth;
+	for (int y = minY; y <= maxY; y++) {
+		float centerY = y + 0.5f;
+		auto row0 = L::set(e0.y * centerY + e0.z);
+		auto row1 = L::set(e1.y * centerY + e1.z);
+		auto row2 = L::set(e2.y * centerY + e2.z);
+		auto rowDepth = L::set(depth.y * centerY + depth.z);
+		float *pixels = tile + (y - tileY) * OCCLUSION_TILE_WIDTH - tileX;
+
+		for (int x = minX; x <= maxX; x += L::width) {
+			auto centerX = simd::add(L::set(static_cast<float>(x)), offsets);
+			auto inside = simd::minimum(
+				simd::minimum(simd::add(simd::mul(L::set(e0.x), centerX), row0), simd::add(simd::mul(L::set(e1.x), centerX), row1)),
+				simd::add(simd::mul(L::set(e2.x), centerX), row2)
+			);
+			auto z = simd::add(simd::mul(L::set(depth.x), centerX), rowDepth);
+			auto current = L::load(pixels + x);
+			L::store(pixels + x, simd::select(simd::greaterEqual(inside, zero), simd::minimum(current, z), current));
+		}
+	}
+}
+
+void OcclusionBuffer::rasterizeTile(int tile) {
+	int tileX = tile % OCCLUSION_TILES_X * OCCLUSION_TILE_WIDTH;
+	int tileY = tile / OCCLUSION_TILES_X * OCCLUSION_TILE_HEIGHT;
+	float *pixels = depths.data() + tile * TILE_SIZE;
+	for (auto index : bins[tile]) {
+		#if defined(SIMD_LANES_AVX2)
+			rasterizeLanes<simd::Float8>(triangles[index], pixels, tileX, tileY);
+		#elif defined(SIMD_LANES_SSE2)
+			rasterizeLanes<simd::Float4>(triangles[index], pixels, tileX, tileY);
+		#else
+			rasterizeLanes<float>(triangles[index], pixels, tileX, tileY);
+		#endif
+	}
+	tileMaxDepths[tile] = *std::max_element(pixels, pixels + TILE_SIZE);
+}
+
+void OcclusionBuffer::rasterize() {
+	if (!pool) {
+		for (int tile = 0; tile < OCCLUSION_TILES_X * OCCLUSION_TILES_Y; tile++) rasterizeTile(tile);
+		return;
+	}
+
+	pool->parallelFor(OCCLUSION_TILES_X * OCCLUSION_TILES_Y, [this](size_t tile) {
+		if (!bins[tile].empty()) rasterizeTile(tile);
+	});
+}
+
+bool OcclusionBuffer::isVisible(const AABB &bounds, const glm::mat4 &viewProjection) const {
+	if (bounds.isEmpty()) return false;
+
+	glm::vec2 lower(std::numeric_limits<float>::max());
+	glm::vec2 upper(-std::numeric_limits<float>::max());
+	float nearest = 1.0f;
+	for (int corner = 0; corner < 8; corner++) {
+		glm::vec3 position(
+			corner & 1 ? bounds.max.x : bounds.min.x,
+			corner & 2 ? bounds.max.y : bounds.min.y,
+			corner & 4 ? bounds.max.z : bounds.min.z
+		);
+		auto clip = viewProjection * glm::vec4(position, 1.0f);
+		// Reaches the near plane, where nothing can be in front of it.
+		if (clip.w <= 0.0f || clip.z < -clip.w) return true;
+
+		auto ndc = glm::vec3(clip) / clip.w;
+		auto screen = glm::vec2((ndc.x * 0.5f + 0.5f) * OCCLUSION_WIDTH, (ndc.y * 0.5f + 0.5f) * OCCLUSION_HEIGHT);
+		lower = glm::min(lower, screen);
+		upper = glm::max(upper, screen);
+		nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+	}
+
+	int minX = std::max(0, static_cast<int>(std::floor(lower.x)));
+	int minY = std::max(0, static_cast<int>(std::floor(lower.y)));
+	int maxX = std::min(OCCLUSION_WIDTH - 1, static_cast<int>(std::floor(upper.x)));
+	int maxY = std::min(OCCLUSION_HEIGHT - 1, static_cast<int>(std::floor(upper.y)));
+	// Off screen is for frustum culling to decide.
+	if (minX > maxX || minY > maxY) return true;
+
+	for (int tileRow = minY / OCCLUSION_TILE_HEIGHT; tileRow <= maxY / OCCLUSION_TILE_HEIGHT; tileRow++) {
+		for (int tileColumn = minX / OCCLUSION_TILE_WIDTH; tileColumn <= maxX / OCCLUSION_TILE_WIDTH; tileColumn++) {
+			int tile = tileRow * OCCLUSION_TILES_X + tileColumn;
+			if (tileMaxDepths[tile] < nearest) continue;
+
+			int tileX = tileColumn * OCCLUSION_TILE_WIDTH;
+			int tileY = tileRow * OCCLUSION_TILE_HEIGHT;
+			const float *pixels = depths.data() + tile * TILE_SIZE;
+			for (int y = std::max(minY, tileY); y <= std::min(maxY, tileY + OCCLUSION_TILE_HEIGHT - 1); y++) {
+				const float *row = pixels + (y - tileY) * OCCLUSION_TILE_WIDTH - tileX;
+				for (int x = std::max(minX, tileX); x <= std::min(maxX, tileX + OCCLUSION_TILE_WIDTH - 1); x++)
+					if (row[x] >= nearest) return true;
+			}
+		}
+	}
+	return false;
+}
+
+float OcclusionBuffer::getDepth(int x, int y) const {
+	if (x < 0 || x >= OCCLUSION_WIDTH || y < 0 || y >= OCCLUSION_HEIGHT)
+		throw std::out_of_range("Pixel (" + std::to_string(x) + ", " + std::to_string(y) + ") is outside the occlusion buffer.");
+	int tile = y / OCCLUSION_TILE_HEIGHT * OCCLUSION_TILES_X + x / OCCLUSION_TILE_WIDTH;
+	return depths[tile * TILE_SIZE + (y % OCCLUSION_TILE_HEIGHT) * OCCLUSION_TILE_WIDTH + x % OCCLUSION_TILE_WIDTH];
+}
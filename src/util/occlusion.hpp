@@ -0,0 +1,56 @@
+#pragma once
+
+#include "bounds.hpp"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+const int OCCLUSION_WIDTH = 256;
+const int OCCLUSION_HEIGHT = 128;
+const int OCCLUSION_TILE_WIDTH = 32;
+const int OCCLUSION_TILE_HEIGHT = 16;
+const int OCCLUSION_TILES_X = OCCLUSION_WIDTH / OCCLUSION_TILE_WIDTH;
+const int OCCLUSION_TILES_Y = OCCLUSION_HEIGHT / OCCLUSION_TILE_HEIGHT;
+
+class OcclusionBuffer {
+	private:
+		// Edge functions `a * x + b * y + c` are non-negative inside.
+		struct Triangle {
+			glm::vec3 edges[3];
+			glm::vec3 depth;
+			int minX, minY, maxX, maxY;
+		};
+
+		std::vector<glm::vec4> clipPositions {};
+		std::vector<Triangle> triangles {};
+		std::vector<std::vector<uint32_t>> bins;
+		std::vector<float> depths;
+		std::vector<float> tileMaxDepths;
+		ThreadPool *pool;
+
+		void addClipTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c);
+		void addScreenTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c);
+		void rasterizeTile(int tile);
+
+	public:
+		OcclusionBuffer(ThreadPool *pool = nullptr);
+
+		void clear();
+		// Back faces are kept, so single walls occlude from either side.
+		template <typename Vertex>
+		void addOccluder(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, const glm::mat4 &modelViewProjection) {
+			clipPositions.clear();
+			for (const auto &vertex : vertices) clipPositions.push_back(modelViewProjection * glm::vec4(vertex.position, 1.0f));
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+				addClipTriangle(clipPositions[indices[i]], clipPositions[indices[i + 1]], clipPositions[indices[i + 2]]);
+		};
+		void rasterize();
+
+		// Pixels count as covered by their centers, so a sliver under one pixel wide may be rejected.
+		bool isVisible(const AABB &bounds, const glm::mat4 &viewProjection) const;
+
+		float getDepth(int x, int y) const;
+};
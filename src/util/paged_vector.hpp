@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Elements never move, since it grows a page at a time.
+template <typename T, size_t PAGE_SIZE = 1024>
+class PagedVector {
+	private:
+		struct Page {
+			alignas(T) unsigned char data[sizeof(T) * PAGE_SIZE];
+		};
+
+		std::vector<std::unique_ptr<Page>> pages {};
+		size_t count = 0;
+
+		T *slot(size_t index) const { return reinterpret_cast<T *>(pages[index / PAGE_SIZE]->data) + index % PAGE_SIZE; };
+
+	public:
+		PagedVector() = default;
+		PagedVector(const PagedVector &) = delete;
+		PagedVector &operator=(const PagedVector &) = delete;
+		~PagedVector() { clear(); };
+
+		size_t size() const { return count; };
+		bool empty() const { return count == 0; };
+
+		T &operator[](size_t index) { return *slot(index); };
+		const T &operator[](size_t index) const { return *slot(index); };
+		T &back() { return *slot(count - 1); };
+
+		size_t pageCount() const { return (count + PAGE_SIZE - 1) / PAGE_SIZE; };
+		T *page(size_t index) { return reinterpret_cast<T *>(pages[index]->data); };
+		size_t pageLength(size_t index) const { return index + 1 < pageCount() ? PAGE_SIZE : count - index * PAGE_SIZE; };
+
+		void reserve(size_t n) {
+			while (pages.size() * PAGE_SIZE < n) pages.push_back(std::unique_ptr<Page>(new Page));
+		};
+
+		template <typename... Args>
+		T &emplace_back(Args &&...args) {
+			if (count == pages.size() * PAGE_SIZE) pages.push_back(std::unique_ptr<Page>(new Page));
+			auto *element = new (slot(count)) T(std::forward<Args>(args)...);
+			count++;
+			return *element;
+		};
+
+		void push_back(T value) { emplace_back(std::move(value)); };
+		void pop_back() { slot(--count)->~T(); };
+
+		void resize(size_t n) {
+			while (count < n) emplace_back();
+			while (count > n) pop_back();
+		};
+
+		void clear() {
+			while (count > 0) pop_back();
+			pages.clear();
+		};
+};
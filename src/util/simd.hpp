@@ -0,0 +1,82 @@
+#pragma once
+
+#if defined(__AVX2__)
+#define SIMD_LANES_AVX2
+#define SIMD_LANES_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_LANES_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace simd {
+
+// Wrapped so registers can be template arguments without losing their alignment attributes.
+template <typename V>
+struct Lane;
+
+template <>
+struct Lane<float> {
+	static const int width = 1;
+	static float load(const float *p) { return *p; };
+	static float set(float value) { return value; };
+	static void store(float *p, float value) { *p = value; };
+};
+
+inline float add(float a, float b) { return a + b; }
+inline float sub(float a, float b) { return a - b; }
+inline float mul(float a, float b) { return a * b; }
+inline float div(float a, float b) { return a / b; }
+inline float minimum(float a, float b) { return a < b ? a : b; }
+inline float maximum(float a, float b) { return a > b ? a : b; }
+// Masks are only meaningful to `select`.
+inline float greaterEqual(float a, float b) { return a >= b ? 1.0f : 0.0f; }
+inline float select(float mask, float a, float b) { return mask != 0.0f ? a : b; }
+
+#ifdef SIMD_LANES_SSE2
+struct Float4 {
+	__m128 v;
+};
+
+template <>
+struct Lane<Float4> {
+	static const int width = 4;
+	static Float4 load(const float *p) { return { _mm_loadu_ps(p) }; };
+	static Float4 set(float value) { return { _mm_set1_ps(value) }; };
+	static void store(float *p, Float4 value) { _mm_storeu_ps(p, value.v); };
+};
+
+inline Float4 add(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline Float4 sub(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline Float4 mul(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline Float4 div(Float4 a, Float4 b) { return { _mm_div_ps(a.v, b.v) }; }
+inline Float4 minimum(Float4 a, Float4 b) { return { _mm_min_ps(a.v, b.v) }; }
+inline Float4 maximum(Float4 a, Float4 b) { return { _mm_max_ps(a.v, b.v) }; }
+inline Float4 greaterEqual(Float4 a, Float4 b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+inline Float4 select(Float4 mask, Float4 a, Float4 b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+#endif
+
+#ifdef SIMD_LANES_AVX2
+struct Float8 {
+	__m256 v;
+};
+
+template <>
+struct Lane<Float8> {
+	static const int width = 8;
+	static Float8 load(const float *p) { return { _mm256_loadu_ps(p) }; };
+	static Float8 set(float value) { return { _mm256_set1_ps(value) }; };
+	static void store(float *p, Float8 value) { _mm256_storeu_ps(p, value.v); };
+};
+
+inline Float8 add(Float8 a, Float8 b) { return { _mm256_add_ps(a.v, b.v) }; }
+inline Float8 sub(Float8 a, Float8 b) { return { _mm256_sub_ps(a.v, b.v) }; }
+inline Float8 mul(Float8 a, Float8 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+inline Float8 div(Float8 a, Float8 b) { return { _mm256_div_ps(a.v, b.v) }; }
+inline Float8 minimum(Float8 a, Float8 b) { return { _mm256_min_ps(a.v, b.v) }; }
+inline Float8 maximum(Float8 a, Float8 b) { return { _mm256_max_ps(a.v, b.v) }; }
+inline Float8 greaterEqual(Float8 a, Float8 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+inline Float8 select(Float8 mask, Float8 a, Float8 b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+#endif
+
+}
@@ -0,0 +1,106 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <utility>
+
+ThreadPool::ThreadPool(size_t nThreads) {
+	nThreads = std::max<size_t>(nThreads, 1);
+	for (size_t i = 0; i < nThreads; i++)
+		workers.emplace_back([this] { work(); });
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	taskAvailable.notify_all();
+	for (auto &worker : workers) worker.join();
+}
+
+void ThreadPool::work() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock(mutex);
+			taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (tasks.empty()) return;
+			task = std::move(tasks.front());
+			tasks.pop();
+			running++;
+		}
+
+		task();
+
+		{
+			std::lock_guard lock(mutex);
+			running--;
+			if (running == 0 && tasks.empty()) idle.notify_all();
+		}
+	}
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+	{
+		std::lock_guard lock(mutex);
+		tasks.push(std::move(task));
+	}
+	taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+	std::unique_lock lock(mutex);
+	idle.wait(lock, [this] { return running == 0 && tasks.empty(); });
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &body) {
+	if (count == 0) return;
+	if (count == 1 || workers.size() < 2) {
+		for (size_t i = 0; i < count; i++) body(i);
+		return;
+	}
+
+	// Helpers may run after the loop is over, so they share ownership of its state.
+	struct Job {
+		const std::function<void(size_t)> *body;
+		size_t count;
+		std::atomic<size_t> next = 0;
+		size_t finished = 0;
+		std::exception_ptr error {};
+		std::mutex mutex {};
+		std::condition_variable done {};
+	};
+	auto job = std::make_shared<Job>();
+	job->body = &body;
+	job->count = count;
+
+	auto run = [](Job &job) {
+		size_t nFinished = 0;
+		std::exception_ptr error;
+		for (auto i = job.next++; i < job.count; i = job.next++) {
+			try {
+				(*job.body)(i);
+			} catch (...) {
+				if (!error) error = std::current_exception();
+			}
+			nFinished++;
+		}
+		if (nFinished == 0) return;
+
+		std::lock_guard lock(job.mutex);
+		if (error && !job.error) job.error = error;
+		job.finished += nFinished;
+		if (job.finished == job.count) job.done.notify_all();
+	};
+
+	auto nHelpers = std::min(count, workers.size()) - 1;
+	for (size_t i = 0; i < nHelpers; i++) submit([job, run] { run(*job); });
+	run(*job);
+
+	std::unique_lock lock(job->mutex);
+	job->done.wait(lock, [&] { return job->finished == job->count; });
+	if (job->error) std::rethrow_exception(job->error);
+}
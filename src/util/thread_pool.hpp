@@ -0,0 +1,33 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+	private:
+		std::vector<std::thread> workers {};
+		std::queue<std::function<void()>> tasks {};
+		std::mutex mutex {};
+		std::condition_variable taskAvailable {};
+		std::condition_variable idle {};
+		size_t running = 0;
+		bool stopping = false;
+
+		void work();
+
+	public:
+		ThreadPool(size_t nThreads = std::thread::hardware_concurrency());
+		~ThreadPool();
+
+		size_t size() const { return workers.size(); };
+		void submit(std::function<void()> task);
+		// Must not be called from a worker.
+		void wait();
+		// The caller takes part, so this may nest; the first exception from `body` is rethrown.
+		void parallelFor(size_t count, const std::function<void(size_t)> &body);
+};
@@ -0,0 +1,170 @@
+#include "transform_batch.hpp"
+
+#include "simd.hpp"
+
+void TransformBatch::clear() {
+	positionX.clear();
+	positionY.clear();
+	positionZ.clear();
+	orientationX.clear();
+	orientationY.clear();
+	orientationZ.clear();
+	orientationW.clear();
+	scaleX.clear();
+	scaleY.clear();
+	scaleZ.clear();
+}
+
+void TransformBatch::push(const glm::vec3 &position, const glm::quat &orientation, const glm::vec3 &scale) {
+	positionX.push_back(position.x);
+	positionY.push_back(position.y);
+	positionZ.push_back(position.z);
+	orientationX.push_back(orientation.x);
+	orientationY.push_back(orientation.y);
+	orientationZ.push_back(orientation.z);
+	orientationW.push_back(orientation.w);
+	scaleX.push_back(scale.x);
+	scaleY.push_back(scale.y);
+	scaleZ.push_back(scale.z);
+}
+
+TransformArrays TransformBatch::getArrays() const {
+	return {
+		.positionX = positionX.data(),
+		.positionY = positionY.data(),
+		.positionZ = positionZ.data(),
+		.orientationX = orientationX.data(),
+		.orientationY = orientationY.data(),
+		.orientationZ = orientationZ.data(),
+		.orientationW = orientationW.data(),
+		.scaleX = scaleX.data(),
+		.scaleY = scaleY.data(),
+		.scaleZ = scaleZ.data(),
+		.count = positionX.size(),
+	};
+}
+
+// `normal` is R * S^-1.
+template <typename V>
+struct Matrices {
+	V model[4][3];
+	V normal[3][3];
+};
+
+template <typename V>
+Matrices<V> computeLanes(const TransformArrays &transforms, size_t i) {
+	using L = simd::Lane<V>;
+	auto qx = L::load(transforms.orientationX + i);
+	auto qy = L::load(transforms.orientationY + i);
+	auto qz = L::load(transforms.orientationZ + i);
+	auto qw = L::load(transforms.orientationW + i);
+	auto one = L::set(1.0f);
+	auto two = L::set(2.0f);
+
+	auto xx = simd::mul(qx, qx), yy = simd::mul(qy, qy), zz = simd::mul(qz, qz);
+	auto xy = simd::mul(qx, qy), xz = simd::mul(qx, qz), yz = simd::mul(qy, qz);
+	auto wx = simd::mul(qw, qx), wy = simd::mul(qw, qy), wz = simd::mul(qw, qz);
+
+	// Same expansion as glm::mat3_cast.
+	V rotation[3][3] = {
+		{ simd::sub(one, simd::mul(two, simd::add(yy, zz))), simd::mul(two, simd::add(xy, wz)), simd::mul(two, simd::sub(xz, wy)) },
+		{ simd::mul(two, simd::sub(xy, wz)), simd::sub(one, simd::mul(two, simd::add(xx, zz))), simd::mul(two, simd::add(yz, wx)) },
+		{ simd::mul(two, simd::add(xz, wy)), simd::mul(two, simd::sub(yz, wx)), simd::sub(one, simd::mul(two, simd::add(xx, yy))) },
+	};
+	V scale[3] = {
+		L::load(transforms.scaleX + i),
+		L::load(transforms.scaleY + i),
+		L::load(transforms.scaleZ + i),
+	};
+
+	Matrices<V> matrices;
+	for (int column = 0; column < 3; column++) {
+		auto inverseScale = simd::div(one, scale[column]);
+		for (int row = 0; row < 3; row++) {
+			matrices.model[column][row] = simd::mul(rotation[column][row], scale[column]);
+			matrices.normal[column][row] = simd::mul(rotation[column][row], inverseScale);
+		}
+	}
+	matrices.model[3][0] = L::load(transforms.positionX + i);
+	matrices.model[3][1] = L::load(transforms.positionY + i);
+	matrices.model[3][2] = L::load(transforms.positionZ + i);
+	return matrices;
+}
+
+void storeLanes(const Matrices<float> &matrices, glm::mat4 *models, glm::mat3 *normals) {
+	for (int column = 0; column < 4; column++) {
+		const auto *m = matrices.model[column];
+		(*models)[column] = glm::vec4(m[0], m[1], m[2], column == 3 ? 1.0f : 0.0f);
+	}
+	if (!normals) return;
+	for (int column = 0; column < 3; column++) {
+		const auto *n = matrices.normal[column];
+		(*normals)[column] = glm::vec3(n[0], n[1], n[2]);
+	}
+}
+
+#ifdef SIMD_LANES_SSE2
+void storeLanes(const Matrices<simd::Float4> &matrices, glm::mat4 *models, glm::mat3 *normals) {
+	for (int column = 0; column < 4; column++) {
+		auto x = matrices.model[column][0].v;
+		auto y = matrices.model[column][1].v;
+		auto z = matrices.model[column][2].v;
+		auto w = _mm_set1_ps(column == 3 ? 1.0f : 0.0f);
+		_MM_TRANSPOSE4_PS(x, y, z, w);
+		_mm_storeu_ps(&models[0][column][0], x);
+		_mm_storeu_ps(&models[1][column][0], y);
+		_mm_storeu_ps(&models[2][column][0], z);
+		_mm_storeu_ps(&models[3][column][0], w);
+	}
+	if (!normals) return;
+
+	for (int column = 0; column < 3; column++) {
+		__m128 lanes[4] = { matrices.normal[column][0].v, matrices.normal[column][1].v, matrices.normal[column][2].v, _mm_setzero_ps() };
+		_MM_TRANSPOSE4_PS(lanes[0], lanes[1], lanes[2], lanes[3]);
+		for (int k = 0; k < 4; k++) {
+			auto *p = &normals[k][column][0];
+			// Each store spills a float into the next column, so the last one must not.
+			if (column < 2) {
+				_mm_storeu_ps(p, lanes[k]);
+			} else {
+				_mm_storel_pi(reinterpret_cast<__m64 *>(p), lanes[k]);
+				_mm_store_ss(p + 2, _mm_movehl_ps(lanes[k], lanes[k]));
+			}
+		}
+	}
+}
+#endif
+
+#ifdef SIMD_LANES_AVX2
+void storeLanes(const Matrices<simd::Float8> &matrices, glm::mat4 *models, glm::mat3 *normals) {
+	Matrices<simd::Float4> low, high;
+	for (int column = 0; column < 4; column++) {
+		for (int row = 0; row < 3; row++) {
+			low.model[column][row] = { _mm256_castps256_ps128(matrices.model[column][row].v) };
+			high.model[column][row] = { _mm256_extractf128_ps(matrices.model[column][row].v, 1) };
+		}
+	}
+	for (int column = 0; column < 3; column++) {
+		for (int row = 0; row < 3; row++) {
+			low.normal[column][row] = { _mm256_castps256_ps128(matrices.normal[column][row].v) };
+			high.normal[column][row] = { _mm256_extractf128_ps(matrices.normal[column][row].v, 1) };
+		}
+	}
+	storeLanes(low, models, normals);
+	storeLanes(high, models + 4, normals ? normals + 4 : nullptr);
+}
+#endif
+
+void computeModelMatrices(const TransformArrays &transforms, glm::mat4 *models, glm::mat3 *normals) {
+	size_t i = 0;
+	#ifdef SIMD_LANES_AVX2
+		for (; i + 8 <= transforms.count; i += 8)
+			storeLanes(computeLanes<simd::Float8>(transforms, i), models + i, normals ? normals + i : nullptr);
+	#endif
+	#ifdef SIMD_LANES_SSE2
+		for (; i + 4 <= transforms.count; i += 4)
+			storeLanes(computeLanes<simd::Float4>(transforms, i), models + i, normals ? normals + i : nullptr);
+	#endif
+	for (; i < transforms.count; i++)
+		storeLanes(computeLanes<float>(transforms, i), models + i, normals ? normals + i : nullptr);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <cstddef>
+#include <vector>
+
+struct TransformArrays {
+	const float *positionX;
+	const float *positionY;
+	const float *positionZ;
+	const float *orientationX;
+	const float *orientationY;
+	const float *orientationZ;
+	const float *orientationW;
+	const float *scaleX;
+	const float *scaleY;
+	const float *scaleZ;
+	size_t count;
+};
+
+class TransformBatch {
+	private:
+		std::vector<float> positionX {}, positionY {}, positionZ {};
+		std::vector<float> orientationX {}, orientationY {}, orientationZ {}, orientationW {};
+		std::vector<float> scaleX {}, scaleY {}, scaleZ {};
+
+	public:
+		void clear();
+		void push(const glm::vec3 &position, const glm::quat &orientation, const glm::vec3 &scale);
+		size_t size() const { return positionX.size(); };
+		TransformArrays getArrays() const;
+};
+
+void computeModelMatrices(const TransformArrays &transforms, glm::mat4 *models, glm::mat3 *normals);
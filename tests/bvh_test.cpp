@@ -0,0 +1,125 @@
+#include "../src/util/bounds.hpp"
+#include "../src/util/bvh.hpp"
+#include "../src/util/frustum.hpp"
+#include "../src/util/thread_pool.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+const size_t QUERIES = 64;
+
+AABB randomBox(std::mt19937 &random) {
+	std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> sizes(0.1f, 5.0f);
+	glm::vec3 center(positions(random), positions(random), positions(random));
+	glm::vec3 extents(sizes(random), sizes(random), sizes(random));
+	return { center - extents, center + extents };
+}
+
+template <typename T>
+bool sameResults(std::vector<T> actual, std::vector<T> expected) {
+	std::sort(actual.begin(), actual.end());
+	std::sort(expected.begin(), expected.end());
+	return actual == expected;
+}
+
+size_t checkQueries(const BVH &bvh, const std::vector<AABB> &bounds, std::mt19937 &random, const std::string &name) {
+	std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> sizes(1.0f, 30.0f);
+	std::uniform_real_distribution<float> directions(-1.0f, 1.0f);
+	size_t failures = 0;
+	auto fail = [&](const std::string &query, size_t i) {
+		std::cerr << name << ": " << query << " query " << i << " does not match." << std::endl;
+		failures++;
+	};
+
+	for (size_t i = 0; i < QUERIES; i++) {
+		glm::vec3 center(positions(random), positions(random), positions(random));
+		glm::vec3 extents(sizes(random), sizes(random), sizes(random));
+		AABB box { center - extents, center + extents };
+		std::vector<uint32_t> actual, expected;
+		bvh.queryAABB(box, [&](uint32_t primitive) { actual.push_back(primitive); });
+		for (uint32_t j = 0; j < bounds.size(); j++) {
+			if (bounds[j].overlaps(box)) expected.push_back(j);
+		}
+		if (!sameResults(actual, expected)) fail("AABB", i);
+	}
+
+	for (size_t i = 0; i < QUERIES; i++) {
+		BoundingSphere sphere { glm::vec3(positions(random), positions(random), positions(random)), sizes(random) };
+		std::vector<uint32_t> actual, expected;
+		bvh.querySphere(sphere, [&](uint32_t primitive) { actual.push_back(primitive); });
+		for (uint32_t j = 0; j < bounds.size(); j++) {
+			if (bounds[j].overlaps(sphere.center, sphere.radius)) expected.push_back(j);
+		}
+		if (!sameResults(actual, expected)) fail("sphere", i);
+	}
+
+	for (size_t i = 0; i < QUERIES; i++) {
+		glm::vec3 origin(positions(random), positions(random), positions(random));
+		glm::vec3 direction(directions(random), directions(random), directions(random));
+		float maxDistance = 150.0f;
+		std::vector<std::pair<uint32_t, float>> actual, expected;
+		bvh.queryRay(origin, direction, maxDistance, [&](uint32_t primitive, float distance) { actual.push_back({ primitive, distance }); });
+		for (uint32_t j = 0; j < bounds.size(); j++) {
+			float distance = bounds[j].intersectRay(origin, 1.0f / direction, maxDistance);
+			if (distance >= 0.0f) expected.push_back({ j, distance });
+		}
+		if (!sameResults(actual, expected)) fail("ray", i);
+	}
+
+	auto projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 80.0f);
+	for (size_t i = 0; i < QUERIES; i++) {
+		glm::vec3 eye(positions(random), positions(random), positions(random));
+		glm::vec3 target(positions(random), positions(random), positions(random));
+		Frustum frustum(projection * glm::lookAt(eye, target, glm::vec3(0.0f, 1.0f, 0.0f)));
+		std::vector<std::pair<uint32_t, bool>> actual, expected;
+		bvh.queryFrustum(frustum, [&](uint32_t primitive, bool inside) { actual.push_back({ primitive, inside }); });
+		for (uint32_t j = 0; j < bounds.size(); j++) {
+			auto planeMask = FRUSTUM_ALL_PLANES;
+			auto containment = frustum.test(bounds[j], planeMask);
+			if (containment != OUTSIDE) expected.push_back({ j, containment == INSIDE });
+		}
+		if (!sameResults(actual, expected)) fail("frustum", i);
+	}
+
+	return failures;
+}
+
+int main() {
+	std::mt19937 random(42);
+	size_t failures = 0;
+
+	std::vector<AABB> bounds;
+	for (size_t i = 0; i < 1000; i++) bounds.push_back(randomBox(random));
+	BVH bvh;
+	bvh.build(bounds);
+	failures += checkQueries(bvh, bounds, random, "serial build");
+
+	for (uint32_t i = 0; i < bounds.size(); i += 3) {
+		bounds[i] = randomBox(random);
+		bvh.update(i, bounds[i]);
+	}
+	failures += checkQueries(bvh, bounds, random, "refit");
+
+	ThreadPool pool(4);
+	std::vector<AABB> manyBounds;
+	for (size_t i = 0; i < BVH_PARALLEL_THRESHOLD * 2 + 1; i++) manyBounds.push_back(randomBox(random));
+	BVH parallelBVH;
+	parallelBVH.build(manyBounds, &pool);
+	failures += checkQueries(parallelBVH, manyBounds, random, "parallel build");
+
+	if (failures > 0) {
+		std::cerr << failures << " mismatches." << std::endl;
+		return 1;
+	}
+	std::cout << "All queries match." << std::endl;
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "../src/util/bounds.hpp"
+#include "../src/util/occlusion.hpp"
+#include "../src/util/thread_pool.hpp"
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+const float EPSILON = 1e-5f;
+
+struct Vertex {
+	glm::vec3 position;
+};
+
+const std::vector<unsigned int> QUAD_INDICES = { 0, 1, 2, 0, 2, 3 };
+
+std::vector<Vertex> quad(const glm::vec3 &corner, const glm::vec3 &u, const glm::vec3 &v) {
+	return { { corner }, { corner + u }, { corner + u + v }, { corner + v } };
+}
+
+AABB box(const glm::vec3 &center, float extent) {
+	return { center - glm::vec3(extent), center + glm::vec3(extent) };
+}
+
+glm::vec3 toScreen(const glm::mat4 &viewProjection, const glm::vec3 &position) {
+	auto clip = viewProjection * glm::vec4(position, 1.0f);
+	auto ndc = glm::vec3(clip) / clip.w;
+	return glm::vec3((ndc.x * 0.5f + 0.5f) * OCCLUSION_WIDTH, (ndc.y * 0.5f + 0.5f) * OCCLUSION_HEIGHT, ndc.z * 0.5f + 0.5f);
+}
+
+int main() {
+	size_t failures = 0;
+	auto expect = [&](bool condition, const std::string &what) {
+		if (condition) return;
+		std::cerr << what << std::endl;
+		failures++;
+	};
+
+	auto view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	auto projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f);
+	auto viewProjection = projection * view;
+
+	OcclusionBuffer wall;
+	wall.addOccluder(quad(glm::vec3(-2.0f, -2.0f, -10.0f), glm::vec3(4.0f, 0.0f, 0.0f), glm::vec3(0.0f, 4.0f, 0.0f)), QUAD_INDICES, viewProjection);
+	wall.rasterize();
+	expect(!wall.isVisible(box(glm::vec3(0.0f, 0.0f, -20.0f), 0.5f), viewProjection), "A box behind the wall is visible.");
+	expect(wall.isVisible(box(glm::vec3(0.0f, 0.0f, -5.0f), 0.5f), viewProjection), "A box in front of the wall is hidden.");
+	expect(wall.isVisible(box(glm::vec3(10.0f, 0.0f, -20.0f), 0.5f), viewProjection), "A box beside the wall is hidden.");
+	expect(wall.isVisible(box(glm::vec3(0.0f, 0.0f, -10.0f), 0.5f), viewProjection), "A box through the wall is hidden.");
+	expect(wall.isVisible(box(glm::vec3(4.0f, 0.0f, -20.0f), 0.5f), viewProjection), "A box behind the wall's edge is hidden.");
+	expect(wall.isVisible(box(glm::vec3(0.0f, 0.0f, 0.0f), 0.5f), viewProjection), "A box around the camera is hidden.");
+
+	// Depth is affine in screen space, so it is checked against the projected triangle.
+	glm::vec3 corners[3] = { glm::vec3(-7.3f, -3.1f, -12.0f), glm::vec3(6.9f, -2.2f, -25.0f), glm::vec3(0.4f, 4.7f, -18.0f) };
+	std::vector<Vertex> triangle = { { corners[0] }, { corners[1] }, { corners[2] } };
+	OcclusionBuffer tilted;
+	tilted.addOccluder(triangle, { 0, 1, 2 }, viewProjection);
+	tilted.rasterize();
+	glm::vec3 screen[3];
+	for (int i = 0; i < 3; i++) screen[i] = toScreen(viewProjection, corners[i]);
+	auto edge = [&](int i, float x, float y) {
+		const auto &from = screen[i];
+		const auto &to = screen[(i + 1) % 3];
+		return ((to.x - from.x) * (y - from.y) - (to.y - from.y) * (x - from.x)) / glm::length(glm::vec2(to - from));
+	};
+	auto area = edge(0, screen[2].x, screen[2].y);
+	for (int y = 0; y < OCCLUSION_HEIGHT; y++) {
+		for (int x = 0; x < OCCLUSION_WIDTH; x++) {
+			float centerX = x + 0.5f;
+			float centerY = y + 0.5f;
+			float distances[3];
+			for (int i = 0; i < 3; i++) distances[i] = area > 0.0f ? edge(i, centerX, centerY) : -edge(i, centerX, centerY);
+			// Centers right on an edge may go either way.
+			if (std::abs(distances[0]) < 0.01f || std::abs(distances[1]) < 0.01f || std::abs(distances[2]) < 0.01f) continue;
+
+			float expected = 1.0f;
+			if (distances[0] > 0.0f && distances[1] > 0.0f && distances[2] > 0.0f) {
+				// Barycentric weights from the distances to the opposite edges.
+				float weights[3];
+				for (int i = 0; i < 3; i++) weights[i] = distances[(i + 1) % 3] * glm::length(glm::vec2(screen[(i + 2) % 3] - screen[(i + 1) % 3]));
+				expected = (weights[0] * screen[0].z + weights[1] * screen[1].z + weights[2] * screen[2].z) / (weights[0] + weights[1] + weights[2]);
+			}
+			if (std::abs(tilted.getDepth(x, y) - expected) > EPSILON)
+				expect(false, "Pixel (" + std::to_string(x) + ", " + std::to_string(y) + ") has the wrong depth.");
+		}
+	}
+
+	// The floor starts behind the camera, so it is only drawn once clipped.
+	OcclusionBuffer floor;
+	floor.addOccluder(quad(glm::vec3(-50.0f, -1.0f, 5.0f), glm::vec3(100.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -35.0f)), QUAD_INDICES, viewProjection);
+	floor.rasterize();
+	expect(floor.getDepth(OCCLUSION_WIDTH / 2, 0) < 1.0f, "The floor is not rasterized below the camera.");
+	expect(!floor.isVisible(box(glm::vec3(0.0f, -5.0f, -20.0f), 0.5f), viewProjection), "A box under the floor is visible.");
+	expect(floor.isVisible(box(glm::vec3(0.0f, 1.0f, -20.0f), 0.5f), viewProjection), "A box above the floor is hidden.");
+
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(-30.0f, 30.0f);
+	std::uniform_real_distribution<float> depths(-60.0f, 5.0f);
+	std::vector<Vertex> vertices;
+	std::vector<unsigned int> indices;
+	for (unsigned int i = 0; i < 3000; i++) {
+		vertices.push_back({ glm::vec3(positions(random), positions(random), depths(random)) });
+		indices.push_back(i);
+	}
+
+	ThreadPool pool(4);
+	OcclusionBuffer serial;
+	OcclusionBuffer pooled(&pool);
+	serial.addOccluder(vertices, indices, viewProjection);
+	pooled.addOccluder(vertices, indices, viewProjection);
+	serial.rasterize();
+	pooled.rasterize();
+	size_t mismatches = 0;
+	for (int y = 0; y < OCCLUSION_HEIGHT; y++) {
+		for (int x = 0; x < OCCLUSION_WIDTH; x++) {
+			if (serial.getDepth(x, y) != pooled.getDepth(x, y)) mismatches++;
+		}
+	}
+	expect(mismatches == 0, std::to_string(mismatches) + " pixels differ between pooled and single-threaded rasterization.");
+
+	if (failures > 0) {
+		std::cerr << failures << " failures." << std::endl;
+		return 1;
+	}
+	std::cout << "All occlusion checks pass." << std::endl;
+	return 0;
+}
@@ -0,0 +1,79 @@
+#include "../src/ecs/components/transform.hpp"
+#include "../src/util/transform_batch.hpp"
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const float EPSILON = 1e-4f;
+
+// Relative, so big scales and their tiny inverses are held to the same standard.
+bool near(float a, float b) {
+	return std::abs(a - b) <= EPSILON * std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+}
+
+template <typename M>
+bool near(const M &a, const M &b) {
+	for (int column = 0; column < a.length(); column++) {
+		for (int row = 0; row < a[column].length(); row++) {
+			if (!near(a[column][row], b[column][row])) return false;
+		}
+	}
+	return true;
+}
+
+int main() {
+	// Not a multiple of any lane width, so the wide and scalar paths both run.
+	const size_t count = 1027;
+	std::mt19937 random(42);
+	std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+	std::uniform_real_distribution<float> angles(-360.0f, 360.0f);
+	std::uniform_real_distribution<float> scales(0.1f, 10.0f);
+
+	std::vector<Transform> transforms;
+	TransformBatch batch;
+	for (size_t i = 0; i < count; i++) {
+		glm::vec3 position(positions(random), positions(random), positions(random));
+		glm::vec3 rotation(angles(random), angles(random), angles(random));
+		auto scale = i % 4 == 0 ? glm::vec3(scales(random)) : glm::vec3(scales(random), scales(random), scales(random));
+		transforms.emplace_back(position, rotation, scale);
+		batch.push(position, transforms.back().getOrientation(), scale);
+	}
+
+	std::vector<glm::mat4> models(count);
+	std::vector<glm::mat3> normals(count);
+	computeModelMatrices(batch.getArrays(), models.data(), normals.data());
+
+	size_t failures = 0;
+	for (size_t i = 0; i < count; i++) {
+		const auto &expected = transforms[i].getMatrix();
+		auto expectedNormal = glm::transpose(glm::inverse(glm::mat3(expected)));
+		if (!near(models[i], expected)) {
+			std::cerr << "Model matrix " << i << " does not match." << std::endl;
+			failures++;
+		}
+		if (!near(normals[i], expectedNormal)) {
+			std::cerr << "Normal matrix " << i << " does not match." << std::endl;
+			failures++;
+		}
+	}
+
+	std::vector<glm::mat4> modelsOnly(count);
+	computeModelMatrices(batch.getArrays(), modelsOnly.data(), nullptr);
+	for (size_t i = 0; i < count; i++) {
+		if (modelsOnly[i] != models[i]) {
+			std::cerr << "Model matrix " << i << " changes without normals." << std::endl;
+			failures++;
+		}
+	}
+
+	if (failures > 0) {
+		std::cerr << failures << " mismatches." << std::endl;
+		return 1;
+	}
+	std::cout << "All " << count << " transforms match." << std::endl;
+	return 0;
+}